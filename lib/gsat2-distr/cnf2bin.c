@@ -0,0 +1,61 @@
+#include <stdlib.h>             /* strtol */
+#include <stdio.h>              /* printf */
+#include <string.h>             /* strcmp */
+#ifdef _MSC_VER
+#include "getopt.h"
+#else
+#include <unistd.h>             /* getopt */
+#endif
+#include "util_files.h"
+#include "sat_inst.h"
+#include "num_opts.h"
+/*-----------------------------------------------------------------------------*/
+char synopsis[] = "cnf2bin <options> [dimacs-file [binary-file]]\n"
+"\t-w number                        max literals in a clause, default no limit\n"
+"\t converts a DIMACS CNF into the binary instance format read by gsat2\n"
+"\t and probSAT, with the occurrence index precomputed\n"
+;
+/*-----------------------------------------------------------------------------*/
+int main (int argc, char** argv) {
+    int     width=0;    /* max clause length, 0: no limit */
+    file_t  in =  {NULL, stdin};    /* instance input */
+    file_t  out = {NULL, stdout};   /* binary output */
+    int     err=0;      /* err indicator */
+    char    opt;        /* options scanning */
+    inst_t  inst;       /* instance */
+
+    /* ---------------------- options ----------------------- */
+    while ((opt = getopt(argc, argv, "w:")) != -1) {
+         switch (opt) {
+         case 'w': width = par_int_min (argv[0], opt, &err, 1);     /* max clause length, checked on input */
+                   break;
+         default:  fprintf (stderr, "%s", synopsis); 
+                   return EXIT_FAILURE;  /* unknown parameter, e.g. -h */
+         }
+    }
+    if (optind < argc) in.name = argv[optind];                      /* input file on the command line */
+    if (optind+1 < argc) out.name = argv[optind+1];                 /* output file on the command line */
+    if (err) return EXIT_FAILURE;                                   /* stop here if any error */
+
+    /* ----------------------- conversion -------------------- */
+    if (! util_file_in (&in)) return EXIT_FAILURE;
+    err = inst_read(&inst, in.file, width);
+    if (err) {
+        inst_read_fail (err, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (! util_file_bin (&out)) return EXIT_FAILURE;
+    err = inst_write_bin(&inst, out.file);
+    if (err == ERR_ALLOC) {
+        inst_read_fail (err, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (err || fflush (out.file) != 0) {
+        fprintf (stderr, "%s: binary output failure\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    inst_forget(&inst);
+    util_file_close (&out);
+    util_file_close (&in);
+    return EXIT_SUCCESS;
+}
@@ -11,7 +11,7 @@
 #include <signal.h>
 #endif
 
-int cont=1;                     /* do continue iterating */
+ctrlc_flag_t cont=1;            /* do continue iterating */
 
 /*-----------------------------------------------------------------------------*/
 /*  CTRL-C handler                                                             */
@@ -41,7 +41,7 @@ void handler (int signo) {
 #endif
 
 /*-----------------------------------------------------------------------------*/
-int* establish_handler (const char* prog) {
+ctrlc_flag_t* establish_handler (const char* prog) {
 #ifdef _MSC_VER
     if (! SetConsoleCtrlHandler(CtrlHandler, TRUE)) { 
         fprintf (stderr, "%s: cannot establish a signal handler\n", prog); 
@@ -1,5 +1,11 @@
 #ifndef CTRLC_HANDLER_H
 #define CTRLC_HANDLER_H
 
-int* establish_handler (const char* prog);
+#ifdef _MSC_VER
+typedef volatile int ctrlc_flag_t;
+#else
+#include <stdatomic.h>
+typedef _Atomic int ctrlc_flag_t;   /* cleared by the handler, read by any thread */
+#endif
+ctrlc_flag_t* establish_handler (const char* prog);
 #endif
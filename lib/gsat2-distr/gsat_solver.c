@@ -0,0 +1,1035 @@
+/*-----------------------------------------------------------------------------*/
+/*   the GSAT search behind gsat_solver.h: incremental gains, walkers and      */
+/*   the solver handle; no globals, handles are independent of each other     */
+/*-----------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>             /* memcpy */
+#include <time.h>               /* clock_gettime */
+#ifndef _MSC_VER
+#include <stdatomic.h>
+#include <pthread.h>
+#endif
+#include "gsat_solver.h"
+
+/*-----------------------------------------------------------------------------*/
+typedef struct {
+    int  vars_no;
+    int  gain_max;      /* all gains lie within -gain_max .. gain_max */
+    int* score;         /* score[v] is the change in sat clauses when v flips */
+    int* order;         /* variables by ascending score */
+    int* where;         /* where[v] is the position of v in order */
+    int* start;         /* start[g] is where the bucket of gain g begins in order */
+} gain_bkt;
+typedef gain_bkt* gain_bkt_t;
+
+/*-----------------------------------------------------------------------------*/
+/*      maintenance of the false clauses list                                  */
+/*-----------------------------------------------------------------------------*/
+static inline void gw_false_add (false_list_t fals, int cli) {
+    fals->clause[fals->no] = cli;
+    fals->where[cli] = fals->no;
+    fals->no++;
+}
+static inline void gw_false_del (false_list_t fals, int cli) {
+    int last = fals->clause[--fals->no];            /* the last one takes the vacated place */
+    fals->clause[fals->where[cli]] = last;
+    fals->where[last] = fals->where[cli];
+}
+/*-----------------------------------------------------------------------------*/
+/*   clause width w: when all clauses have w literals, clause i is body[i*w]   */
+/*   .. body[i*w+w-1] and start is not needed; the _w functions below are      */
+/*   inlined with w constant into the kernels for w = 3, 4, 5, 7, where the    */
+/*   loops over a clause unroll, and with w 0 into the generic ones            */
+/*-----------------------------------------------------------------------------*/
+#define GW_BEG(inst,cli,w) ((w) ? (inst)->body+(cli)*(w) : (inst)->body+(inst)->start[cli])
+#define GW_LEN(inst,cli,w) ((w) ? (w) : (inst)->start[(cli)+1]-(inst)->start[cli])
+#if defined(__GNUC__) && __GNUC__ >= 8                         /* -O alone leaves 5 or 7 rolled */
+#define GW_UNROLL _Pragma("GCC unroll 8")
+#else
+#define GW_UNROLL
+#endif
+/*-----------------------------------------------------------------------------*/
+/*   narrow n: with n 1 the counters are cnt8_t and the clause indices are     */
+/*   taken from occ16, a quarter and a half of the bytes, for instances that   */
+/*   fit them; inlined with n constant, as w                                   */
+/*-----------------------------------------------------------------------------*/
+static inline cnt_val gw_cnt (void* cnt, int cli, int n) {
+    return n ? ((cnt8_t)cnt)[cli] : ((cnt_t)cnt)[cli];
+}
+static inline void gw_cnt_set (void* cnt, int cli, cnt_val c, int n) {
+    if (n) ((cnt8_t)cnt)[cli] = c; else ((cnt_t)cnt)[cli] = c;
+}
+static inline int gw_occ (var_info_t varinf, int i, int n) {
+    return n ? varinf->occ16[i] : varinf->occ[i];
+}
+/*-----------------------------------------------------------------------------*/
+/*      for all clauses in sol, update the number of true literals in cnt,     */
+/*      collect the false clauses and sum up the flip gains in score:          */
+/*      flipping any variable of a false clause makes it sat, flipping the     */
+/*      true one of a clause with a single true literal breaks it, clauses    */
+/*      with more true literals do not count; that is what gw_neg_flip_gain    */
+/*      and gw_pos_flip_gain give, from a single pass over the clauses         */
+/*-----------------------------------------------------------------------------*/
+static inline void gw_gain_false (int* score, inst_t* inst, int cli, int w) {
+    literal_t* lit = GW_BEG(inst,cli,w);
+    int k, len = GW_LEN(inst,cli,w);
+    GW_UNROLL
+    for (k=0; k<len; k++) score[lit[k] > 0 ? lit[k] : -lit[k]]++;
+}
+static inline int gw_eval_from (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score, int from, int w, int n) {
+    int sat = 0, i, k, len, tv;
+    literal_t* lit;
+    cnt_val c;
+    for (i=from; i<inst->length; i++) {
+        c = 0;
+        tv = 0;
+        lit = GW_BEG(inst,i,w);
+        len = GW_LEN(inst,i,w);
+        GW_UNROLL
+        for (k=0; k<len; k++) {
+    	    c+=sol[lit[k]];
+            tv += -(int)sol[lit[k]] & (lit[k] > 0 ? lit[k] : -lit[k]);  /* the true variable, if just one */
+        }
+        gw_cnt_set (cnt, i, c, n);
+        if (c > 0) {
+            sat++;
+            if (c == 1) score[tv]--;
+        } else {
+            gw_false_add (fals, i);
+            gw_gain_false (score, inst, i, w);
+        }
+    }
+    return sat;
+}
+static inline int gw_eval_w (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score, int w, int n) {
+    fals->no = 0;
+    memset (score, 0, (inst->vars_no+1)*sizeof(int));
+    return gw_eval_from (sol, inst, cnt, fals, score, 0, w, n);
+}
+int gw_eval (sol_t sol, inst_t* inst, cnt_t cnt, false_list_t fals, int* score) {
+    return gw_eval_w (sol, inst, cnt, fals, score, 0, 0);
+}
+/*-----------------------------------------------------------------------------*/
+/*      build the var_info structure telling where each literal is used        */
+/*      a single arena holds the occurrence index in CSR form and the clauses  */
+/*      with their starts taken over from inst; a binary instance brings the   */
+/*      index and the clauses mapped, then the arena holds just the header     */
+/*      and occ16, the index in 16 bits for the narrow kernels, built when     */
+/*      the clause indices and their true literal counts fit                   */
+/*      all this is read only during the search, shared by all walkers         */
+/*-----------------------------------------------------------------------------*/
+#define GW_ALIGN 64                                             /* cache line */
+static size_t gw_carve (size_t* top, size_t size) {             /* next aligned block of the arena */
+    size_t at = (*top + GW_ALIGN-1) & ~(size_t)(GW_ALIGN-1);
+    *top = at + size;
+    return at;
+}
+static char* gw_arena_reserve (void** raw, size_t top) {        /* the arena, aligned, in *raw to free */
+    if (!(*raw = calloc (top+GW_ALIGN, 1))) return NULL;
+    return (char*)*raw + (GW_ALIGN - (size_t)*raw % GW_ALIGN) % GW_ALIGN;
+}
+var_info_t gw_varinf_build (inst_t* inst) {
+    var_info_t varinf;
+    void* raw; char* arena;
+    size_t top=0, at_ix=0, at_occ=0, at_body=0, at_start=0, at_occ16=0, i;
+    int n=inst->vars_no, own=!inst->occ_ix;                     /* a binary instance comes indexed */
+    int narrow = inst->length <= CLAUSE_IX16_MAX+1 && inst->width <= CNT8_MAX;
+
+    gw_carve (&top, sizeof(var_info));
+    if (own) {
+        at_ix   = gw_carve (&top, (2*n+2)*sizeof(int));
+        at_occ  = gw_carve (&top, inst->lits_no*sizeof(clause_ix_t));     /* one occurrence per literal */
+        at_body = gw_carve (&top, inst->lits_no*sizeof(literal_t));
+        at_start= gw_carve (&top, (inst->length+1)*sizeof(int));
+    }
+    if (narrow) at_occ16 = gw_carve (&top, inst->lits_no*sizeof(clause_ix16_t));
+    if (!(arena = gw_arena_reserve (&raw, top))) return NULL;
+
+    varinf = (var_info_t)arena;
+    varinf->arena = raw;
+    varinf->vars_no = n;
+    if (own) {
+        varinf->occ_ix = (int*)(arena+at_ix) + n;               /* so that occ_ix[l] is valid for negative l */
+        varinf->occ = (clause_ix_t*)(arena+at_occ);
+        inst_occ_fill (inst, varinf->occ_ix, varinf->occ);
+
+        memcpy (arena+at_body, inst->body, inst->lits_no*sizeof(literal_t));     /* the arena owns the clauses now */
+        memcpy (arena+at_start, inst->start, (inst->length+1)*sizeof(int));
+        free (inst->body);
+        free (inst->start);
+        inst->body = (literal_t*)(arena+at_body);
+        inst->start = (int*)(arena+at_start);
+        inst->shared = 1;
+    } else {
+        varinf->occ_ix = inst->occ_ix;
+        varinf->occ = inst->occ;
+    }
+    if (narrow) {
+        varinf->occ16 = (clause_ix16_t*)(arena+at_occ16);
+        for (i=0; i<(size_t)inst->lits_no; i++) varinf->occ16[i] = varinf->occ[i];
+    }
+    return varinf;
+}
+/*-----------------------------------------------------------------------------*/
+/*      debug dump of the var_info structure to out                            */
+/*-----------------------------------------------------------------------------*/
+int gw_varinf_dump (var_info_t varinf,inst_t* inst, FILE* out) {
+    int i,v;
+    for (v=1; v<=inst->vars_no; v++) {
+        fprintf(out,"%3d P %3d:", v, varinf->occ_ix[v+1]-varinf->occ_ix[v]); 
+        for (i=varinf->occ_ix[v]; i<varinf->occ_ix[v+1]; i++) fprintf(out," %3d",varinf->occ[i]);
+        fprintf(out,"\n");
+        fprintf(out,"%3d N %3d:", v, varinf->occ_ix[-v+1]-varinf->occ_ix[-v]); 
+        for (i=varinf->occ_ix[-v]; i<varinf->occ_ix[-v+1]; i++) fprintf(out," %3d",varinf->occ[i]);
+        fprintf(out,"\n");
+    }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*      the whole arena goes, including the clauses                            */
+/*-----------------------------------------------------------------------------*/
+var_info_t gw_varinf_forget (var_info_t varinf) {
+    if (varinf) free (varinf->arena);
+    return NULL;
+}
+/*-----------------------------------------------------------------------------*/
+/*      determine the change in satisfied clause number when variable v 1->0   */
+/*-----------------------------------------------------------------------------*/
+int gw_neg_flip_gain (var_info_t varinf, cnt_t cnt, int v) {
+    int i, gain=0;
+    for (i=varinf->occ_ix[v]; i<varinf->occ_ix[v+1]; i++) {    /* for all clauses where the variable occurs in a positive literal */
+        if (cnt[varinf->occ[i]] == 1) gain--;
+    }
+    for (i=varinf->occ_ix[-v]; i<varinf->occ_ix[-v+1]; i++) {  /* for all clauses where the variable occurs in a negative literal */
+        if (cnt[varinf->occ[i]] == 0) gain++;
+    }
+    return gain;
+}
+/*-----------------------------------------------------------------------------*/
+/*      determine the change in satisfied clause number when variable v 0->1   */
+/*-----------------------------------------------------------------------------*/
+int gw_pos_flip_gain (var_info_t varinf, cnt_t cnt, int v) {
+    int i, gain=0;
+    for (i=varinf->occ_ix[v]; i<varinf->occ_ix[v+1]; i++) {    /* for all clauses where the variable occurs in a positive literal */
+        if (cnt[varinf->occ[i]] == 0) gain++;
+    }
+    for (i=varinf->occ_ix[-v]; i<varinf->occ_ix[-v+1]; i++) {  /* for all clauses where the variable occurs in a negative literal */
+        if (cnt[varinf->occ[i]] == 1) gain--;
+    }
+    return gain;
+}
+/*-----------------------------------------------------------------------------*/
+/*   flip gains of all variables, kept sorted by gain in buckets               */
+/*   order[] lists the variables by ascending gain, the bucket of gain g is    */
+/*   order[start[g] .. start[g+1]-1], where[v] is the position of v in order   */
+/*   a gain changes by one at a time, so moving a variable to the adjacent     */
+/*   bucket is a single swap with the bucket boundary                          */
+/*-----------------------------------------------------------------------------*/
+static int gw_gain_max (var_info_t varinf, inst_t* inst) {
+    int v, occ, max = 0;
+    for (v=1; v<=inst->vars_no; v++) {                          /* a gain never exceeds the occurrences */
+        occ = varinf->occ_ix[v+1]-varinf->occ_ix[v] + varinf->occ_ix[-v+1]-varinf->occ_ix[-v];
+        if (occ > max) max = occ;
+    }
+    return max;
+}
+/*-----------------------------------------------------------------------------*/
+/*      sort the gains computed into the buckets                               */
+/*-----------------------------------------------------------------------------*/
+void gw_gain_sort (gain_bkt_t gains) {
+    int v, g, n = gains->vars_no;
+    for (g=-gains->gain_max; g<=gains->gain_max+1; g++) gains->start[g] = 0;
+    for (v=1; v<=n; v++) {
+        gains->start[gains->score[v]+1]++;                      /* counting sort, sizes first */
+    }
+    for (g=-gains->gain_max+1; g<=gains->gain_max+1; g++) gains->start[g] += gains->start[g-1];
+    for (v=1; v<=n; v++) {
+        g = gains->score[v];
+        gains->where[v] = gains->start[g];
+        gains->order[gains->start[g]] = v;
+        gains->start[g]++;
+    }
+    for (g=gains->gain_max+1; g>-gains->gain_max; g--) gains->start[g] = gains->start[g-1];
+    gains->start[-gains->gain_max] = 0;
+}
+/*-----------------------------------------------------------------------------*/
+static inline void gw_gain_swap (gain_bkt_t gains, int v, int pos) {
+    int u = gains->order[pos];
+    gains->order[gains->where[v]] = u;
+    gains->where[u] = gains->where[v];
+    gains->order[pos] = v;
+    gains->where[v] = pos;
+}
+static inline void gw_gain_inc (gain_bkt_t gains, int v) {
+    int g = gains->score[v]++;
+    gw_gain_swap (gains, v, gains->start[g+1]-1);               /* to the top of its bucket */
+    gains->start[g+1]--;                                        /* and over the boundary */
+}
+static inline void gw_gain_dec (gain_bkt_t gains, int v) {
+    int g = gains->score[v]--;
+    gw_gain_swap (gains, v, gains->start[g]);                   /* to the bottom of its bucket */
+    gains->start[g]++;
+}
+/*-----------------------------------------------------------------------------*/
+/*   determine which variable flip gives the max gain                          */
+/*   the max gain bucket is the one holding the last variable in order         */
+/*-----------------------------------------------------------------------------*/
+int gw_max_flip_var (gain_bkt_t gains, rng_state_t* rng) {
+    unsigned chosen, listocc;
+    int maxgain, n = gains->vars_no;
+    maxgain = gains->score[gains->order[n-1]];
+    listocc = n - gains->start[maxgain];
+    if (listocc == 1) return gains->order[n-1];
+    chosen = rng_next_below_r (rng, listocc);
+    return gains->order[gains->start[maxgain]+chosen];
+}
+/*-----------------------------------------------------------------------------*/
+/*      the only true literal of clause cli other than those of variable v     */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_true_var (inst_t* inst, sol_t sol, int cli, int v, int w) {
+    literal_t* lit = GW_BEG(inst,cli,w);
+    int k, len = GW_LEN(inst,cli,w);
+    GW_UNROLL
+    for (k=0; k<len; k++) {
+        if (sol[lit[k]] && lit[k] != v && lit[k] != -v) return lit[k] > 0 ? lit[k] : -lit[k];
+    }
+    return 0;
+}
+/*-----------------------------------------------------------------------------*/
+/*      clause cli gained its first true literal (of v) or lost its last one,  */
+/*      so flipping any other variable in it stops or starts making it sat     */
+/*-----------------------------------------------------------------------------*/
+static inline void gw_gain_others (gain_bkt_t gains, inst_t* inst, int cli, int v, int made_sat, int w) {
+    literal_t* lit = GW_BEG(inst,cli,w);
+    int k, u, len = GW_LEN(inst,cli,w);
+    GW_UNROLL
+    for (k=0; k<len; k++) {
+        u = lit[k] > 0 ? lit[k] : -lit[k];
+        if (u == v) continue;
+        if (made_sat) gw_gain_dec (gains, u); else gw_gain_inc (gains, u);
+    }
+}
+/*-----------------------------------------------------------------------------*/
+/*      a literal of v becomes true in clause cli with cnt true literals       */
+/*-----------------------------------------------------------------------------*/
+static inline void gw_gain_up (gain_bkt_t gains, inst_t* inst, sol_t sol, cnt_val cnt, int cli, int v, int w) {
+    int u;
+    if (cnt == 0) gw_gain_others (gains, inst, cli, v, 1, w);
+    else if (cnt == 1 && (u = gw_true_var (inst, sol, cli, v, w))) gw_gain_inc (gains, u);    /* no longer breaks it */
+}
+/*-----------------------------------------------------------------------------*/
+/*      a literal of v becomes false in clause cli with cnt true literals      */
+/*-----------------------------------------------------------------------------*/
+static inline void gw_gain_down (gain_bkt_t gains, inst_t* inst, sol_t sol, cnt_val cnt, int cli, int v, int w) {
+    int u;
+    if (cnt == 1) gw_gain_others (gains, inst, cli, v, 0, w);
+    else if (cnt == 2 && (u = gw_true_var (inst, sol, cli, v, w))) gw_gain_dec (gains, u);    /* would break it now */
+}
+/*-----------------------------------------------------------------------------*/
+/*      realize flip 1->0 of variable v, update cnt, gains and false clauses   */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_make_neg_flip (var_info_t varinf, inst_t* inst, void* cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v, int w, int n) {
+    int i, cli, gain=0;
+    cnt_val c;
+    for (i=varinf->occ_ix[v]; i<varinf->occ_ix[v+1]; i++) {    /* for all clauses where the variable occurs in a positive literal */
+        cli = gw_occ (varinf, i, n);
+        c = gw_cnt (cnt, cli, n);
+        if (c == 1) { gain--; gw_false_add (fals, cli); }
+        gw_gain_down (gains, inst, sol, c, cli, v, w);
+        gw_cnt_set (cnt, cli, c-1, n);
+    }
+    for (i=varinf->occ_ix[-v]; i<varinf->occ_ix[-v+1]; i++) {  /* for all clauses where the variable occurs in a negative literal */
+        cli = gw_occ (varinf, i, n);
+        c = gw_cnt (cnt, cli, n);
+        if (c == 0) { gain++; gw_false_del (fals, cli); }
+        gw_gain_up (gains, inst, sol, c, cli, v, w);
+        gw_cnt_set (cnt, cli, c+1, n);
+    }
+    return gain;
+}
+/*-----------------------------------------------------------------------------*/
+/*      realize flip 0->1 of variable v, update cnt, gains and false clauses   */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_make_pos_flip (var_info_t varinf, inst_t* inst, void* cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v, int w, int n) {
+    int i, cli, gain=0;
+    cnt_val c;
+    for (i=varinf->occ_ix[v]; i<varinf->occ_ix[v+1]; i++) {    /* for all clauses where the variable occurs in a positive literal */
+        cli = gw_occ (varinf, i, n);
+        c = gw_cnt (cnt, cli, n);
+        if (c == 0) { gain++; gw_false_del (fals, cli); }
+        gw_gain_up (gains, inst, sol, c, cli, v, w);
+        gw_cnt_set (cnt, cli, c+1, n);
+    }
+    for (i=varinf->occ_ix[-v]; i<varinf->occ_ix[-v+1]; i++) {  /* for all clauses where the variable occurs in a negative literal */
+        cli = gw_occ (varinf, i, n);
+        c = gw_cnt (cnt, cli, n);
+        if (c == 1) { gain--; gw_false_add (fals, cli); }
+        gw_gain_down (gains, inst, sol, c, cli, v, w);
+        gw_cnt_set (cnt, cli, c-1, n);
+    }
+    return gain;
+}
+/*-----------------------------------------------------------------------------*/
+/*      realize the flip of variable v, update cnt, gains and false clauses    */
+/*      flipping v back would undo the gain, so its own score just negates     */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_make_flip_w (var_info_t varinf, inst_t* inst, void* cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v, int w, int n) {
+    int gain=0;
+    if (sol[v]) {
+        gain += gw_make_neg_flip (varinf, inst, cnt, sol, gains, fals, v, w, n);    /* update true literal counters */
+    } else {
+        gain += gw_make_pos_flip (varinf, inst, cnt, sol, gains, fals, v, w, n);
+    }
+    sol_flip (sol, v);
+    while (gains->score[v] > -gain) gw_gain_dec (gains, v);
+    while (gains->score[v] < -gain) gw_gain_inc (gains, v);
+    return gain;
+}
+int gw_make_flip (var_info_t varinf, inst_t* inst, cnt_t cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v) {
+    return gw_make_flip_w (varinf, inst, cnt, sol, gains, fals, v, 0, 0);
+}
+/*-----------------------------------------------------------------------------*/
+/*      randomly choose an unsatisfied clause                                  */
+/*-----------------------------------------------------------------------------*/
+int gw_pick_unsat (false_list_t fals, rng_state_t* rng) {
+    unsigned c;
+    c = rng_next_below_r (rng, fals->no);
+    return fals->clause[c];
+}
+/*-----------------------------------------------------------------------------*/
+/*      randomly choose a variable in a clause                                 */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_pick_var_w (inst_t* inst, void* cnt, int cli, rng_state_t* rng, int w) {
+    literal_t* clause;
+    int pick;
+
+    clause = GW_BEG(inst,cli,w);
+    pick = rng_next_below_r (rng, GW_LEN(inst,cli,w));
+    if (clause[pick] < 0) return -clause[pick];
+    return clause[pick];
+}
+int gw_pick_var (inst_t* inst, cnt_t cnt, int cli, rng_state_t* rng) {
+    return gw_pick_var_w (inst, cnt, cli, rng, 0);
+}
+/*-----------------------------------------------------------------------------*/
+/*   the kernels: what a walker does per try and per flip, for clauses of     */
+/*   any width and for the fixed widths, each also narrow; one is chosen for  */
+/*   the instance; cnt is a cnt_t, for the narrow ones a cnt8_t               */
+/*-----------------------------------------------------------------------------*/
+typedef struct {
+    const char* name;
+    int width;              /* of all clauses, 0: any */
+    int narrow;             /* 8 bit counters, the clauses from occ16 */
+    int (*eval) (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score);
+    int (*make_flip) (var_info_t varinf, inst_t* inst, void* cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v);
+    int (*pick_var) (inst_t* inst, void* cnt, int cli, rng_state_t* rng);
+} gw_kernel_t;
+
+#define GW_KERNEL(id,w,n) \
+static int gw_eval_##id (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score) { \
+    return gw_eval_w (sol, inst, cnt, fals, score, w, n); \
+} \
+static int gw_make_flip_##id (var_info_t varinf, inst_t* inst, void* cnt, sol_t sol, gain_bkt_t gains, false_list_t fals, int v) { \
+    return gw_make_flip_w (varinf, inst, cnt, sol, gains, fals, v, w, n); \
+} \
+static int gw_pick_var_##id (inst_t* inst, void* cnt, int cli, rng_state_t* rng) { \
+    return gw_pick_var_w (inst, cnt, cli, rng, w); \
+}
+GW_KERNEL(0, 0, 0)
+GW_KERNEL(3, 3, 0)
+GW_KERNEL(4, 4, 0)
+GW_KERNEL(5, 5, 0)
+GW_KERNEL(7, 7, 0)
+GW_KERNEL(0n, 0, 1)
+GW_KERNEL(3n, 3, 1)
+GW_KERNEL(4n, 4, 1)
+GW_KERNEL(5n, 5, 1)
+GW_KERNEL(7n, 7, 1)
+
+#define GW_KERNEL_ROW(name,id,w,n) { name, w, n, gw_eval_##id, gw_make_flip_##id, gw_pick_var_##id }
+static const gw_kernel_t gw_kernels[] = {                       /* the generic ones first */
+    GW_KERNEL_ROW("generic", 0, 0, 0), GW_KERNEL_ROW("generic", 0n, 0, 1),
+    GW_KERNEL_ROW("w3", 3, 3, 0),      GW_KERNEL_ROW("w3", 3n, 3, 1),
+    GW_KERNEL_ROW("w4", 4, 4, 0),      GW_KERNEL_ROW("w4", 4n, 4, 1),
+    GW_KERNEL_ROW("w5", 5, 5, 0),      GW_KERNEL_ROW("w5", 5n, 5, 1),
+    GW_KERNEL_ROW("w7", 7, 7, 0),      GW_KERNEL_ROW("w7", 7n, 7, 1),
+    { NULL, 0, 0, NULL, NULL, NULL }
+};
+/*-----------------------------------------------------------------------------*/
+/*   vector kernels of the pass over all clauses at every try, for clauses    */
+/*   all of one width: 8 (AVX2) or 16 (AVX-512) clauses at a time, literal k  */
+/*   of each gathered from body by a stride of the width, its value from sol  */
+/*   by a 4 byte read (sol is padded for it); false clauses are listed in     */
+/*   ascending order as by the scalar eval, so the search stays the same;     */
+/*   narrow, the counts are packed to bytes on the store                       */
+/*-----------------------------------------------------------------------------*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GW_X86
+
+__attribute__((target("avx2")))
+static inline int gw_eval_avx2_n (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score, int n) {
+    int w = inst->width, i, k, sat = 0;
+    int tvs[8] __attribute__((aligned(32)));
+    unsigned m, m1;
+    __m256i ix = _mm256_mullo_epi32 (_mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32 (w));
+    __m256i low = _mm256_set1_epi32 (0xFF), zero = _mm256_setzero_si256 (), one = _mm256_set1_epi32 (1), c, tv, lit, t;
+    fals->no = 0;
+    memset (score, 0, (inst->vars_no+1)*sizeof(int));
+    for (i=0; i+8<=inst->length; i+=8) {
+        c = tv = zero;
+        for (k=0; k<w; k++) {
+            lit = _mm256_i32gather_epi32 (inst->body+i*w+k, ix, 4);
+            t = _mm256_and_si256 (_mm256_i32gather_epi32 ((const int*)sol, lit, 1), low);
+            c = _mm256_add_epi32 (c, t);
+            tv = _mm256_add_epi32 (tv, _mm256_and_si256 (_mm256_sub_epi32 (zero, t), _mm256_abs_epi32 (lit)));
+        }
+        if (n) {
+            t = _mm256_packs_epi32 (c, c);                          /* within each 128 bit lane */
+            t = _mm256_packus_epi16 (t, t);
+            _mm_storel_epi64 ((__m128i*)((cnt8_t)cnt+i), _mm_unpacklo_epi32 (_mm256_castsi256_si128 (t), _mm256_extracti128_si256 (t, 1)));
+        } else {
+            _mm256_storeu_si256 ((__m256i*)((cnt_t)cnt+i), c);
+        }
+        m = _mm256_movemask_ps (_mm256_castsi256_ps (_mm256_cmpeq_epi32 (c, zero)));
+        m1 = _mm256_movemask_ps (_mm256_castsi256_ps (_mm256_cmpeq_epi32 (c, one)));
+        sat += 8 - __builtin_popcount (m);
+        if (m1) {
+            _mm256_store_si256 ((__m256i*)tvs, tv);
+            for (; m1; m1 &= m1-1) score[tvs[__builtin_ctz (m1)]]--;
+        }
+        for (; m; m &= m-1) {
+            gw_false_add (fals, i + __builtin_ctz (m));
+            gw_gain_false (score, inst, i + __builtin_ctz (m), w);
+        }
+    }
+    return sat + gw_eval_from (sol, inst, cnt, fals, score, i, w, n); /* the last few */
+}
+__attribute__((target("avx512f")))
+static inline int gw_eval_avx512_n (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score, int n) {
+    int w = inst->width, i, k, sat = 0;
+    int tvs[16] __attribute__((aligned(64)));
+    unsigned m, m1;
+    __m512i ix = _mm512_mullo_epi32 (_mm512_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32 (w));
+    __m512i low = _mm512_set1_epi32 (0xFF), zero = _mm512_setzero_si512 (), one = _mm512_set1_epi32 (1), c, tv, lit, t;
+    fals->no = 0;
+    memset (score, 0, (inst->vars_no+1)*sizeof(int));
+    for (i=0; i+16<=inst->length; i+=16) {
+        c = tv = zero;
+        for (k=0; k<w; k++) {
+            lit = _mm512_i32gather_epi32 (ix, inst->body+i*w+k, 4);
+            t = _mm512_and_si512 (_mm512_i32gather_epi32 (lit, sol, 1), low);
+            c = _mm512_add_epi32 (c, t);
+            tv = _mm512_mask_add_epi32 (tv, _mm512_test_epi32_mask (t, t), tv, _mm512_abs_epi32 (lit));
+        }
+        if (n) _mm_storeu_si128 ((__m128i*)((cnt8_t)cnt+i), _mm512_cvtepi32_epi8 (c));
+        else _mm512_storeu_si512 ((cnt_t)cnt+i, c);
+        m = _mm512_cmpeq_epi32_mask (c, zero);
+        m1 = _mm512_cmpeq_epi32_mask (c, one);
+        sat += 16 - __builtin_popcount (m);
+        if (m1) {
+            _mm512_store_si512 (tvs, tv);
+            for (; m1; m1 &= m1-1) score[tvs[__builtin_ctz (m1)]]--;
+        }
+        for (; m; m &= m-1) {
+            gw_false_add (fals, i + __builtin_ctz (m));
+            gw_gain_false (score, inst, i + __builtin_ctz (m), w);
+        }
+    }
+    return sat + gw_eval_from (sol, inst, cnt, fals, score, i, w, n);
+}
+#define GW_ISA_EVAL(isa,feature) \
+__attribute__((target(feature))) \
+static int gw_eval_##isa (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score) { \
+    return gw_eval_##isa##_n (sol, inst, cnt, fals, score, 0); \
+} \
+__attribute__((target(feature))) \
+static int gw_eval_##isa##n (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score) { \
+    return gw_eval_##isa##_n (sol, inst, cnt, fals, score, 1); \
+}
+GW_ISA_EVAL(avx2, "avx2")
+GW_ISA_EVAL(avx512, "avx512f")
+#endif
+/*-----------------------------------------------------------------------------*/
+/*      the vector variants of a width kernel, the fastest first; which      */
+/*      the CPU runs is found out at run time, so that one build serves all   */
+/*-----------------------------------------------------------------------------*/
+typedef struct {
+    const char* name;
+    int (*has) (void);      /* the CPU can run it */
+    int (*eval) (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score);
+    int (*eval_n) (sol_t sol, inst_t* inst, void* cnt, false_list_t fals, int* score);     /* narrow */
+} gw_isa_t;
+
+#ifdef GW_X86
+static int gw_has_avx512 (void) { __builtin_cpu_init (); return __builtin_cpu_supports ("avx512f"); }
+static int gw_has_avx2 (void)   { __builtin_cpu_init (); return __builtin_cpu_supports ("avx2"); }
+#endif
+static const gw_isa_t gw_isas[] = {
+#ifdef GW_X86
+    { "avx512", gw_has_avx512, gw_eval_avx512, gw_eval_avx512n },
+    { "avx2", gw_has_avx2, gw_eval_avx2, gw_eval_avx2n },
+#endif
+    { NULL, NULL, NULL, NULL }
+};
+#define GW_KERNEL_NAME 16
+/*-----------------------------------------------------------------------------*/
+/*   the kernel called name, a width kernel or "<width kernel>-<isa>", either */
+/*   with "/16" for the narrow one, or for NULL or "auto" the best one for    */
+/*   the instance and the CPU, narrow when occ16 was built, into kern with    */
+/*   its name in kname; 0 if unknown, not fitting or not run by the CPU       */
+/*-----------------------------------------------------------------------------*/
+static int gw_kernel_choose (inst_t* inst, var_info_t varinf, const char* name, gw_kernel_t* kern, char* kname) {
+    const gw_kernel_t* k;
+    const gw_isa_t* x = NULL;
+    const char* isa;
+    size_t len, end;
+    int w = inst->length && inst->lits_no == inst->length*inst->width ? inst->width : 0;  /* all alike */
+    int narrow;
+
+    if (name && !strcmp (name, "auto")) name = NULL;
+    end = name ? strlen (name) : 0;
+    narrow = name ? end > 3 && !strcmp (name+end-3, "/16") : varinf->occ16 != NULL;
+    if (name && narrow) end -= 3;
+    if (narrow && !varinf->occ16) return 0;
+    isa = name ? memchr (name, '-', end) : NULL;
+    len = isa ? (size_t)(isa++ - name) : end;
+    for (k=gw_kernels; k->name; k++) {
+        if (k->narrow == narrow && (name ? strlen (k->name) == len && !strncmp (k->name, name, len) : k->width == w)) break;
+    }
+    if (!k->name) {
+        if (name) return 0;
+        k = gw_kernels + narrow;                                /* no kernel of its width, the generic one */
+    }
+    if (k->width && k->width != w) return 0;
+    *kern = *k;
+    if (!name || isa) {
+        len = isa ? (size_t)(name+end-isa) : 0;
+        for (x=gw_isas; x->name && (isa ? strlen (x->name) != len || strncmp (x->name, isa, len) : !x->has ()); x++) ;
+        if (!x->name || !k->width) {                            /* vectors for a single width only */
+            if (name) return 0;
+            x = NULL;
+        } else if (!x->has ()) {
+            return 0;
+        } else {
+            kern->eval = narrow ? x->eval_n : x->eval;
+        }
+    }
+    snprintf (kname, GW_KERNEL_NAME, "%s%s%s%s", k->name, x ? "-" : "", x ? x->name : "", narrow ? "/16" : "");
+    kern->name = kname;
+    return 1;
+}
+/*-----------------------------------------------------------------------------*/
+/*   walkers: independent searches over the shared instance and var_info       */
+/*   each has its own counters, solution, gains, false list and RNG stream;    */
+/*   the winner is the walker satisfying the formula in the fewest flips,      */
+/*   the lower id on a tie, so that the outcome does not depend on timing;     */
+/*   a walker stops as soon as it cannot beat the best one found so far        */
+/*-----------------------------------------------------------------------------*/
+#ifdef _MSC_VER
+typedef uint64_t gw_best_t;                     /* walkers run one after another */
+#define gw_best_load(p) (*(p))
+#define gw_cont_load(p) (*(p))
+#define gw_cont_store(p,v) (*(p) = (v))
+#else
+typedef _Atomic uint64_t gw_best_t;
+#define gw_best_load(p) atomic_load_explicit ((p), memory_order_relaxed)
+#define gw_cont_load(p) atomic_load_explicit ((p), memory_order_relaxed)
+#define gw_cont_store(p,v) atomic_store_explicit ((p), (v), memory_order_relaxed)
+#endif
+#define GW_KEY(flips,id) ((uint64_t)(flips) << 32 | (uint64_t)(id))    /* (flips, id) ordered as one number */
+
+typedef struct {
+    inst_t*     inst;
+    var_info_t  varinf;
+    gw_kernel_t kern;           /* the search steps, for the instance */
+    char        kern_name[GW_KERNEL_NAME];
+    int         itrmax;     /* max flips in a try, 0: no limit */
+    int         triesmax;   /* max tries, 0: no limit */
+    int         flipmax;    /* max flips in all tries, 0: no limit */
+    double      deadline;   /* gw_now() to stop at, 0: no limit */
+    uint64_t    pthr;       /* greedy / random decision threshold */
+    gsat_cont_t* pcont;     /* cleared by CTRL-C or gsat_stop */
+    int         debug;      /* debug info to stderr */
+    FILE*       data;       /* iteration log, or NULL */
+    FILE*       trace;      /* detailed trace, or NULL */
+    gw_best_t   best;       /* GW_KEY of the winner so far */
+} gw_run_t;
+
+typedef struct {
+    gw_run_t*    run;
+    int          id;
+    rng_state_t* rng;       /* the stream used, rng_own or the global one */
+    rng_state_t  rng_own;
+    void*        arena;     /* the allocation all below lives in */
+    void*        cnt;       /* true literals counters, per clause, cnt8_t for a narrow kernel */
+    sol_t        sol;
+    bsol_t       bits;      /* sol packed, flipped along */
+    bsol_t       best;      /* the assignment satisfying the most clauses so far, packed */
+    gain_bkt_t   gains;
+    false_list_t fals;
+    int          flips;     /* over all tries */
+    int          satisfied; /* at the end */
+    int          best_sat;  /* by best */
+} gw_walker_t;
+
+/*-----------------------------------------------------------------------------*/
+/*      all the state of a walker in a single arena, as var_info: the          */
+/*      counters, solution and gains touched by every flip first, then the     */
+/*      false list and the packed assignments                                  */
+/*-----------------------------------------------------------------------------*/
+int gw_walker_reserve (gw_walker_t* w, gw_run_t* run, int id) {
+    inst_t* inst = run->inst;
+    size_t top=0, at_gains, at_fals, at_cnt, at_sol, at_score, at_where, at_order, at_start, at_clause, at_fwhere, at_bits, at_best;
+    int n = inst->vars_no, m = inst->length, gmax = gw_gain_max (run->varinf, inst);
+    char* arena;
+
+    w->run = run;
+    w->id = id;
+    at_gains = gw_carve (&top, sizeof(gain_bkt));
+    at_fals  = gw_carve (&top, sizeof(false_list));
+    at_cnt   = gw_carve (&top, m*(run->kern.narrow ? sizeof(cnt8_val) : sizeof(cnt_val)));
+    at_sol   = gw_carve (&top, sol_size (n));
+    at_score = gw_carve (&top, (n+1)*sizeof(int));             /* item 0 is bogus */
+    at_where = gw_carve (&top, (n+1)*sizeof(int));
+    at_order = gw_carve (&top, (n+1)*sizeof(int));
+    at_start = gw_carve (&top, (2*gmax+2)*sizeof(int));
+    at_clause= gw_carve (&top, m*sizeof(clause_ix_t));
+    at_fwhere= gw_carve (&top, m*sizeof(int));
+    at_bits  = gw_carve (&top, BSOL_WORDS(n)*sizeof(bsol_word));
+    at_best  = gw_carve (&top, BSOL_WORDS(n)*sizeof(bsol_word));
+    if (!(arena = gw_arena_reserve (&w->arena, top))) return 0;
+
+    w->cnt = arena+at_cnt;
+    w->sol = sol_place (arena+at_sol, n);
+    w->bits = (bsol_t)(arena+at_bits);
+    w->best = (bsol_t)(arena+at_best);
+    w->gains = (gain_bkt_t)(arena+at_gains);
+    w->gains->vars_no = n;
+    w->gains->gain_max = gmax;
+    w->gains->score = (int*)(arena+at_score);
+    w->gains->where = (int*)(arena+at_where);
+    w->gains->order = (int*)(arena+at_order);
+    w->gains->start = (int*)(arena+at_start) + gmax;           /* so that start[g] is valid for negative g */
+    w->fals = (false_list_t)(arena+at_fals);
+    w->fals->clause = (clause_ix_t*)(arena+at_clause);
+    w->fals->where = (int*)(arena+at_fwhere);
+    return 1;
+}
+void gw_walker_forget (gw_walker_t* w) {
+    free (w->arena);
+    w->arena = NULL;
+}
+/*-----------------------------------------------------------------------------*/
+/*      seconds on a monotonic clock                                           */
+/*-----------------------------------------------------------------------------*/
+static double gw_now (void) {
+#ifdef _MSC_VER
+    return (double)clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+#endif
+}
+#define GW_CLOCK_MASK 4095                      /* look at the clock every 4096 flips */
+/*-----------------------------------------------------------------------------*/
+/*      may a walker go on to have made flips: not stopped, within the         */
+/*      budgets and still able to beat the best walker                         */
+/*-----------------------------------------------------------------------------*/
+static inline int gw_may_go (gw_run_t* run, int flips, int id) {
+    return gw_cont_load (run->pcont)
+        && ((!run->flipmax) || flips <= run->flipmax)
+        && GW_KEY(flips, id) < gw_best_load (&run->best)
+        && ((!run->deadline) || (flips & GW_CLOCK_MASK) || gw_now() < run->deadline);
+}
+/*-----------------------------------------------------------------------------*/
+/*      a walker satisfying the formula offers its key, the least one stays    */
+/*-----------------------------------------------------------------------------*/
+static void gw_best_offer (gw_run_t* run, uint64_t key) {
+#ifdef _MSC_VER
+    if (key < run->best) run->best = key;
+#else
+    uint64_t best = atomic_load (&run->best);
+    while (key < best && !atomic_compare_exchange_weak (&run->best, &best, key));
+#endif
+}
+/*-----------------------------------------------------------------------------*/
+/*      the tries of one walker; all a try needs was reserved with the         */
+/*      walker, a restart only overwrites it, so tries cost no allocation      */
+/*-----------------------------------------------------------------------------*/
+void gw_walk (gw_walker_t* w) {
+    gw_run_t*  run = w->run;
+    inst_t*    inst = run->inst;
+    var_info_t varinf = run->varinf;
+    void*      cnt = w->cnt;
+    sol_t      sol = w->sol;
+    const gw_kernel_t* kern = &run->kern;
+    int tryno, itrno, flips=0, satisfied=0, flipvar, ucli, gain;
+    char* itype;
+
+    tryno = 1;
+    w->best_sat = -1;
+    while (satisfied < inst->length && ((!run->triesmax) || tryno <= run->triesmax)
+           && gw_may_go (run, flips, w->id)
+           && ((!run->deadline) || gw_now() < run->deadline)) {        /* the clock at each try too, as its */
+                                                                    /* flips alone may not reach it */
+
+        bsol_rand_r (w->rng, sol, w->bits, inst->vars_no);             /* random 0/1 assignment, packed too */
+        /* ----------------------- evaluation --------------------- */
+        satisfied = kern->eval (sol, inst, cnt, w->fals, w->gains->score); /* true literals, sat clauses and all flip gains */
+        gw_gain_sort (w->gains);                                        /* sorted into buckets */
+        if (satisfied > w->best_sat) {                                  /* the best so far, n/64 words */
+            w->best_sat = satisfied;
+            bsol_copy (w->bits, w->best, inst->vars_no);
+        }
+    
+        /* ----------------------- debug and trace ---------------- */
+        if (run->data) fprintf (run->data, "%d %d\n", 0, satisfied);
+        if (run->debug) {
+            sol_write(sol, stderr, inst->vars_no); 
+            fprintf(stderr,"satisfied: %d\n",satisfied);
+            for (int i=0; i<inst->length; i++) fprintf(stderr, " %u", gw_cnt (cnt, i, kern->narrow)); 
+            fprintf(stderr, "\n");
+        }
+        if (run->trace) { 
+            fprintf (run->trace, "initial: satisfied %d, solution: ", satisfied);
+            sol_write(sol, run->trace,  inst->vars_no); 
+            fprintf (run->trace, "true literals: ");
+            for (int i=0; i<inst->length; i++) fprintf(run->trace, " %u", gw_cnt (cnt, i, kern->narrow)); 
+            fprintf(run->trace, "\n");
+        }
+        /* ----------------------- gsat inner iteration ----------- */
+        itrno = 1; gain=1;                                              /* stop when formula satisfied, stopped, out of */
+                                                                    /* budget, another walker did better, and then */
+                                                                    /* either iterations unlimited or below limit */
+        while (satisfied < inst->length && ((!run->itrmax) || itrno <= run->itrmax)
+               && gw_may_go (run, flips+1, w->id)) {
+            if (!rng_next_prob_r (w->rng, run->pthr)) {                 /* choose a greedy or random step: greedy */
+                flipvar = gw_max_flip_var (w->gains, w->rng);           /* select the var with max gain to flip */
+                gain = kern->make_flip (varinf, inst, cnt, sol, w->gains, w->fals, flipvar); /* update the true literals counters and gains */
+                itype = "greedy";
+            } else {
+                ucli = gw_pick_unsat (w->fals, w->rng);                 /* pick some unsat clause at random */
+                flipvar = kern->pick_var (inst, cnt, ucli, w->rng);        /* pick a variable in that clause */
+                gain = kern->make_flip (varinf, inst, cnt, sol, w->gains, w->fals, flipvar); /* update the true literals counters and gains */
+                itype = "random";
+            }       
+            satisfied += gain;                                          /* update sat clauses no. */
+            flips++;
+            BSOL_FLIP(w->bits, flipvar);
+            if (satisfied > w->best_sat) {
+                w->best_sat = satisfied;
+                bsol_copy (w->bits, w->best, inst->vars_no);
+            }
+            if (run->data) fprintf (run->data, "%d %d\n", itrno, satisfied);      /* datafile line */
+            if (run->debug) {                                           /* debug info */
+                fprintf(stderr,"%s flipvar %d, satisfied: %d\n",itype, flipvar, satisfied);
+            }
+            if (run->trace) {                                           /* readable trace info */
+                fprintf (run->trace, "itr %d, %s, flipvar %d, satisfied %d, solution: ", itrno, itype, flipvar, satisfied);
+                sol_write(sol, run->trace,  inst->vars_no); 
+                fprintf (run->trace, "true literals: ");
+                for (int i=0; i<inst->length; i++) fprintf(run->trace, " %u", gw_cnt (cnt, i, kern->narrow)); 
+                fprintf(run->trace, "\n");
+            }
+            itrno++;
+        }
+        tryno++;
+    }
+    w->flips = flips;
+    w->satisfied = satisfied;
+    if (satisfied == inst->length) gw_best_offer (run, GW_KEY(flips, w->id));
+}
+/*-----------------------------------------------------------------------------*/
+/*      run all walkers, walker 0 in the calling thread; where threads are     */
+/*      not available or not granted, the walkers run in turn, which by the    */
+/*      rules above gives the same winner                                      */
+/*-----------------------------------------------------------------------------*/
+#ifndef _MSC_VER
+static void* gw_walk_thread (void* arg) {
+    gw_walk ((gw_walker_t*)arg);
+    return NULL;
+}
+#endif
+void gw_walk_all (gw_walker_t* walkers, int jobs) {
+    int i;
+#ifdef _MSC_VER
+    for (i=0; i<jobs; i++) gw_walk (&walkers[i]);
+#else
+    pthread_t* tid = calloc (jobs, sizeof(pthread_t));
+    char* started = calloc (jobs, 1);
+    for (i=1; tid && started && i<jobs; i++) {
+        started[i] = pthread_create (&tid[i], NULL, gw_walk_thread, &walkers[i]) == 0;
+    }
+    gw_walk (&walkers[0]);
+    for (i=1; i<jobs; i++) {
+        if (started && started[i]) pthread_join (tid[i], NULL);
+        else gw_walk (&walkers[i]);
+    }
+    free (tid);
+    free (started);
+#endif
+}
+/*-----------------------------------------------------------------------------*/
+/*      the winner, or when none, the walker with most clauses satisfied       */
+/*-----------------------------------------------------------------------------*/
+gw_walker_t* gw_winner (gw_walker_t* walkers, int jobs) {
+    uint64_t best = gw_best_load (&walkers[0].run->best);
+    int i, top=0;
+    if (best != UINT64_MAX) return &walkers[best & 0xFFFFFFFF];
+    for (i=1; i<jobs; i++) if (walkers[i].satisfied > walkers[top].satisfied) top = i;
+    return &walkers[top];
+}
+/*-----------------------------------------------------------------------------*/
+/*      walkers for a run; on failure the ones made are dropped again          */
+/*-----------------------------------------------------------------------------*/
+gw_walker_t* gw_walkers_forget (gw_walker_t* walkers, int jobs) {
+    int i;
+    if (walkers) {
+        for (i=0; i<jobs; i++) if (walkers[i].run) gw_walker_forget (&walkers[i]);
+        free (walkers);
+    }
+    return NULL;
+}
+gw_walker_t* gw_walkers_reserve (gw_run_t* run, int jobs) {
+    gw_walker_t* walkers;
+    int i;
+    if (!(walkers = calloc (jobs, sizeof(gw_walker_t)))) return NULL;
+    for (i=0; i<jobs; i++) {                                        /* counters, gains, false list */
+        if (!gw_walker_reserve (&walkers[i], run, i)) return gw_walkers_forget (walkers, jobs);
+    }
+    return walkers;
+}
+/*-----------------------------------------------------------------------------*/
+/*      give walker i the stream of base jumped i times, base ends jumped by   */
+/*      all of them; no winner yet                                             */
+/*-----------------------------------------------------------------------------*/
+void gw_walkers_start (gw_walker_t* walkers, int jobs, rng_state_t* base) {
+    int i;
+    for (i=0; i<jobs; i++) {
+        walkers[i].rng_own = *base;                                 /* 2^128 draws apart */
+        walkers[i].rng = &walkers[i].rng_own;
+        rng_jump_r (base);
+    }
+    walkers[0].run->best = UINT64_MAX;
+}
+/*-----------------------------------------------------------------------------*/
+/*   the solver handle                                                         */
+/*-----------------------------------------------------------------------------*/
+struct gsat_solver {
+    inst_t       inst;      /* taken over from the caller */
+    gw_run_t     run;       /* what the walkers share, pointing to inst */
+    gsat_cont_t  cont;      /* continue flag of its own, see gsat_stop */
+    int          jobs;
+    gw_walker_t* walkers;   /* reserved by the first run */
+    gw_walker_t* win;       /* reported by the last run */
+    rng_state_t  rng;       /* where the next run starts */
+};
+
+gsat_solver_t* gsat_create (inst_t* inst) {
+    gsat_solver_t* s;
+    if (!(s = calloc (1, sizeof(gsat_solver_t)))) return NULL;
+    s->inst = *inst;
+    if (!(s->run.varinf = gw_varinf_build (&s->inst))) {          /* inst is still intact */
+        free (s);
+        return NULL;
+    }
+    memset (inst, 0, sizeof(inst_t));                               /* the handle owns it now */
+    s->run.inst = &s->inst;
+    gw_kernel_choose (&s->inst, s->run.varinf, NULL, &s->run.kern, s->run.kern_name);
+    s->run.itrmax = 300;
+    s->run.triesmax = 1;
+    s->run.pthr = rng_prob_thr (0.4);
+    s->run.pcont = &s->cont;
+    s->cont = 1;
+    s->jobs = 1;
+    rng_set_seed_r (&s->rng, GSAT_DEFAULT_SEED);
+    return s;
+}
+gsat_solver_t* gsat_destroy (gsat_solver_t* s) {
+    if (s) {
+        s->walkers = gw_walkers_forget (s->walkers, s->jobs);
+        s->run.varinf = gw_varinf_forget (s->run.varinf);
+        inst_forget (&s->inst);
+        free (s);
+    }
+    return NULL;
+}
+/*-----------------------------------------------------------------------------*/
+void gsat_set_p (gsat_solver_t* s, double p)        { s->run.pthr = rng_prob_thr (p); }
+void gsat_set_itrmax (gsat_solver_t* s, int itrmax) { s->run.itrmax = itrmax; }
+void gsat_set_triesmax (gsat_solver_t* s, int triesmax) { s->run.triesmax = triesmax; }
+void gsat_set_seed (gsat_solver_t* s, uint64_t seed) { rng_set_seed_r (&s->rng, seed); }
+void gsat_set_state (gsat_solver_t* s, const rng_state_t* ps) { s->rng = *ps; }
+void gsat_get_state (gsat_solver_t* s, rng_state_t* ps) { *ps = s->rng; }
+void gsat_set_cont (gsat_solver_t* s, gsat_cont_t* pcont) { s->run.pcont = pcont ? pcont : &s->cont; }
+void gsat_stop (gsat_solver_t* s)                   { gw_cont_store (&s->cont, 0); }
+const char* gsat_kernel (gsat_solver_t* s)          { return s->run.kern_name; }
+
+int gsat_set_kernel (gsat_solver_t* s, const char* name) {
+    gw_kernel_t kern;
+    char kname[GW_KERNEL_NAME];
+    if (!gw_kernel_choose (&s->inst, s->run.varinf, name, &kern, kname)) return 0;
+    if (kern.narrow != s->run.kern.narrow) {                    /* the counters of the walkers change */
+        s->walkers = gw_walkers_forget (s->walkers, s->jobs);
+        s->win = NULL;
+    }
+    s->run.kern = kern;
+    strcpy (s->run.kern_name, kname);
+    s->run.kern.name = s->run.kern_name;
+    return 1;
+}
+
+void gsat_set_jobs (gsat_solver_t* s, int jobs) {
+    if (jobs < 1) jobs = 1;
+    if (jobs == s->jobs) return;
+    s->walkers = gw_walkers_forget (s->walkers, s->jobs);      /* the next run reserves them again */
+    s->win = NULL;
+    s->jobs = jobs;
+}
+void gsat_set_log (gsat_solver_t* s, FILE* data, FILE* trace, int debug) {
+    s->run.data = data;
+    s->run.trace = trace;
+    s->run.debug = debug;
+}
+/*-----------------------------------------------------------------------------*/
+/*      a run: walkers from the current RNG state, within the budgets given    */
+/*-----------------------------------------------------------------------------*/
+int gsat_run (gsat_solver_t* s, int flips, double seconds) {
+    rng_state_t base = s->rng;
+    if (!s->walkers && !(s->walkers = gw_walkers_reserve (&s->run, s->jobs))) return ERR_ALLOC;
+    s->run.flipmax = flips;
+    s->run.deadline = seconds > 0 ? gw_now() + seconds : 0;
+    gw_walkers_start (s->walkers, s->jobs, &base);
+    gw_walk_all (s->walkers, s->jobs);
+    s->win = gw_winner (s->walkers, s->jobs);
+    s->rng = s->jobs == 1 ? s->walkers[0].rng_own : base;         /* a single stream goes on, else past all used */
+    gw_cont_store (&s->cont, 1);                                    /* a stop ends a single run */
+    return s->win->satisfied == s->inst.length;
+}
+/*-----------------------------------------------------------------------------*/
+/*      results of the last run, of the walker reported                        */
+/*-----------------------------------------------------------------------------*/
+const inst_t* gsat_inst (gsat_solver_t* s)  { return &s->inst; }
+int   gsat_flips (gsat_solver_t* s)         { return s->win ? s->win->flips : 0; }
+int   gsat_satisfied (gsat_solver_t* s)     { return s->win ? s->win->satisfied : 0; }
+sol_t gsat_solution (gsat_solver_t* s)      { return s->win ? s->win->sol : NULL; }
+
+static gw_walker_t* gw_best_walker (gsat_solver_t* s) {
+    gw_walker_t* best = NULL;
+    int i;
+    for (i=0; s->win && i<s->jobs; i++) {                        /* a walker that did not start has -1 */
+        if (!best || s->walkers[i].best_sat > best->best_sat) best = &s->walkers[i];
+    }
+    return best;
+}
+int    gsat_best_satisfied (gsat_solver_t* s) { return s->win && gw_best_walker (s)->best_sat > 0 ? gw_best_walker (s)->best_sat : 0; }
+bsol_t gsat_best_solution (gsat_solver_t* s)  { return s->win ? gw_best_walker (s)->best : NULL; }
+int gsat_distance (gsat_solver_t* s, int i, int j) {
+    if (!s->win || i < 0 || j < 0 || i >= s->jobs || j >= s->jobs) return -1;
+    return bsol_distance (s->walkers[i].bits, s->walkers[j].bits, s->inst.vars_no);
+}
+int   gsat_dump (gsat_solver_t* s, FILE* out) { return gw_varinf_dump (s->run.varinf, &s->inst, out); }
@@ -0,0 +1,71 @@
+#ifndef GSAT_SOLVER_H
+#define GSAT_SOLVER_H
+#include <stdio.h>
+#include <stdint.h>
+#include "sat_inst.h"
+#include "sat_sol.h"
+#include "xoshiro256plus.h"
+
+/* --- GSAT solver handle, the search of gsat2 without its command line ---- */
+/* a handle is created from an instance and takes it over, then it can run  */
+/* any number of times; each run continues the RNG stream of the previous   */
+/* one unless a seed or a state is set in between; handles share nothing,   */
+/* so several may run in threads of their own                               */
+
+typedef struct gsat_solver gsat_solver_t;
+
+#define GSAT_DEFAULT_SEED 0x55AA55AA55AA55AAULL     /* as with no RNG options */
+
+gsat_solver_t* gsat_create (inst_t* inst);          /* NULL on allocation failure, */
+                                                    /* *inst emptied on success */
+gsat_solver_t* gsat_destroy (gsat_solver_t* s);     /* with the instance */
+
+/* --- parameters, as the gsat2 options; defaults p 0.4, 300 flips, 1 try -- */
+void gsat_set_p (gsat_solver_t* s, double p);       /* probability of a random step */
+void gsat_set_itrmax (gsat_solver_t* s, int itrmax);        /* flips in a try, 0: no limit */
+void gsat_set_triesmax (gsat_solver_t* s, int triesmax);    /* tries, 0: no limit */
+void gsat_set_jobs (gsat_solver_t* s, int jobs);    /* parallel walkers, the fewest flips wins */
+void gsat_set_seed (gsat_solver_t* s, uint64_t seed);
+void gsat_set_state (gsat_solver_t* s, const rng_state_t* ps);
+void gsat_get_state (gsat_solver_t* s, rng_state_t* ps);    /* where the next run starts */
+void gsat_set_log (gsat_solver_t* s, FILE* data, FILE* trace, int debug);  /* as -d, -t, -D */
+
+/* --- search kernels: "generic" for any instance, "w3", "w4", "w5", "w7" --- */
+/* --- for all clauses of that width, these with "-avx2" or "-avx512" for  */
+/* --- the pass over all clauses at every try done in vectors; any with   */
+/* --- "/16" for byte counters and 16 bit clause indices, for at most      */
+/* --- 65536 clauses of at most 255 literals; the fitting one the CPU runs */
+/* --- is chosen on create, narrow when the instance allows ---------------*/
+int  gsat_set_kernel (gsat_solver_t* s, const char* name);  /* NULL, "auto": the fitting one; */
+                                                    /* 0 if unknown, not fitting or not run by the CPU */
+const char* gsat_kernel (gsat_solver_t* s);
+
+/* --- stopping: a run goes on while *pcont, by default a flag of the handle */
+/* --- which gsat_stop clears, e.g. from another thread; that ends the run  */
+/* --- under way, or the next one if none is, which then sets it again ----*/
+#ifdef _MSC_VER
+typedef volatile int gsat_cont_t;                   /* walkers run one after another */
+#else
+#include <stdatomic.h>
+typedef _Atomic int gsat_cont_t;
+#endif
+void gsat_set_cont (gsat_solver_t* s, gsat_cont_t* pcont);  /* NULL: the own flag again */
+void gsat_stop (gsat_solver_t* s);
+
+/* --- a run within at most flips flips and seconds of time, 0: no limit ---- */
+/* --- 1 when satisfied, 0 when not, ERR_ALLOC ----------------------------- */
+int  gsat_run (gsat_solver_t* s, int flips, double seconds);
+
+/* --- results of the last run: the walker that satisfied the formula in ---- */
+/* --- the fewest flips, or else the one with most clauses satisfied ------- */
+const inst_t* gsat_inst (gsat_solver_t* s);
+int   gsat_flips (gsat_solver_t* s);                /* in all its tries */
+int   gsat_satisfied (gsat_solver_t* s);            /* clauses, at the end */
+sol_t gsat_solution (gsat_solver_t* s);             /* variables from 1, valid until the next run */
+int   gsat_best_satisfied (gsat_solver_t* s);       /* clauses, most at once in a try of any walker */
+bsol_t gsat_best_solution (gsat_solver_t* s);       /* where, packed, valid until the next run */
+int   gsat_distance (gsat_solver_t* s, int i, int j);   /* variables the final assignments */
+                                                    /* of walkers i and j differ in, -1 if none such */
+int   gsat_dump (gsat_solver_t* s, FILE* out);      /* the occurrence index, for debugging */
+
+#endif
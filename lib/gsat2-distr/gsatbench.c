@@ -0,0 +1,167 @@
+/*-----------------------------------------------------------------------------*/
+/*   gsatbench: speed of the gsat and probSAT search kernels                   */
+/*   every instance runs with the generic kernel and with the ones fitting     */
+/*   it, the vector ones too, gsat's also narrow (/16) when the instance      */
+/*   allows, from the same seed, so that all make the same                     */
+/*   flips; the best of the rounds is reported, a line per instance, solver   */
+/*   and kernel, with the time of a restart, from tries of a single flip:     */
+/*   instance solver kernel flips seconds flips/s restart-us                   */
+/*-----------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>             /* getopt */
+#include "gsat_solver.h"
+#include "num_opts.h"
+
+#include "../probSAT-master/probSAT.h"
+
+/*-----------------------------------------------------------------------------*/
+char synopsis[] = "gsatbench <options> dimacs-file...\n"
+"\t-i number                        max flips in a try, default 10000\n"
+"\t-T number                        max tries, default 10\n"
+"\t-p number                        gsat: probability of a random step, default 0.4\n"
+"\t-n number                        rounds, the fastest counts, default 3\n"
+"\t-r hex-number                    seed, default 1\n"
+"\t-R number                        tries timed for the restart time, default 100, 0: none\n"
+;
+
+typedef struct {
+    int      itrmax;
+    int      triesmax;
+    double   p;
+    int      rounds;
+    uint64_t seed;
+    int      restarts;
+} gb_params_t;
+
+/*-----------------------------------------------------------------------------*/
+static double gb_now (void) {
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+static void gb_report (const char* path, const char* solver, const char* kernel, long long flips, double secs, double restart) {
+    printf ("%s %s %s %lld %.4f %.0f %.1f\n", path, solver, kernel, flips, secs, secs > 0 ? flips/secs : 0.0, 1e6*restart);
+    fflush (stdout);
+}
+/*-----------------------------------------------------------------------------*/
+/*      gsat on the instance in path, kernel by kernel                         */
+/*-----------------------------------------------------------------------------*/
+static int gb_gsat (const char* path, gb_params_t* par) {
+    const char* isas[] = { "", "-avx2", "-avx512" };
+    const char* widths[] = { "", "/16" };
+    char kernels[4][32] = { "generic" }, kernel[40];
+    inst_t inst;
+    FILE* in;
+    gsat_solver_t* s;
+    double t, best, restart;
+    int k, n, r, err;
+
+    if (!(in = fopen (path, "rb"))) { perror (path); return 1; }
+    err = inst_read (&inst, in, 0);
+    fclose (in);
+    if (err) { inst_read_fail (err, path); return 1; }
+    if (!(s = gsat_create (&inst))) { inst_forget (&inst); return 1; }
+    gsat_set_p (s, par->p);
+    gsat_set_itrmax (s, par->itrmax);
+    gsat_set_triesmax (s, par->triesmax);
+    for (k=1; k<4; k++) {                                           /* the width kernel, then its vector ones */
+        snprintf (kernels[k], sizeof kernels[k], "%.*s%s", (int)strcspn (gsat_kernel (s), "-/"), gsat_kernel (s), isas[k-1]);
+    }
+    for (k=0; k<4; k++) for (n=0; n<2; n++) {
+        if (k && !strcmp (kernels[k], kernels[0])) continue;        /* nothing fits better */
+        snprintf (kernel, sizeof kernel, "%.*s%s", (int)sizeof kernels[k], kernels[k], widths[n]);
+        if (!gsat_set_kernel (s, kernel)) continue;
+        best = restart = 0;
+        for (r=0; par->restarts && r<par->rounds; r++) {              /* restarts first, flips reported after */
+            gsat_set_itrmax (s, 1);
+            gsat_set_triesmax (s, par->restarts);
+            gsat_set_seed (s, par->seed);
+            t = gb_now ();
+            if (gsat_run (s, 0, 0) < 0) { gsat_destroy (s); return 1; }
+            t = (gb_now () - t) / par->restarts;
+            if (!r || t < restart) restart = t;
+        }
+        gsat_set_itrmax (s, par->itrmax);
+        gsat_set_triesmax (s, par->triesmax);
+        for (r=0; r<par->rounds; r++) {
+            gsat_set_seed (s, par->seed);
+            t = gb_now ();
+            if (gsat_run (s, 0, 0) < 0) { gsat_destroy (s); return 1; }
+            t = gb_now () - t;
+            if (!r || t < best) best = t;
+        }
+        gb_report (path, "gsat", gsat_kernel (s), gsat_flips (s), best, restart);
+    }
+    gsat_destroy (s);
+    return 0;
+}
+/*-----------------------------------------------------------------------------*/
+/*      probSAT on the instance in path, kernel by kernel                      */
+/*-----------------------------------------------------------------------------*/
+static int gb_probsat (const char* path, gb_params_t* par) {
+    const char* isas[] = { "", "-avx2", "-avx512" };
+    const char* widths[] = { "", "/16" };
+    char kernels[4][32] = { "generic" }, kernel[40];
+    probsat_t* ps;
+    long long flips = 0;
+    int satisfied, clauses, k, n, r;
+    double t, best, restart;
+
+    if (!(ps = probsat_create (path))) return 1;
+    for (k=1; k<4; k++) {
+        snprintf (kernels[k], sizeof kernels[k], "%.*s%s", (int)strcspn (probsat_kernel (ps), "-/"), probsat_kernel (ps), isas[k-1]);
+    }
+    for (k=0; k<4; k++) for (n=0; n<2; n++) {
+        if (k && !strcmp (kernels[k], kernels[0])) continue;        /* nothing fits better */
+        snprintf (kernel, sizeof kernel, "%.*s%s", (int)sizeof kernels[k], kernels[k], widths[n]);
+        if (!probsat_set_kernel (ps, kernel)) continue;
+        best = restart = 0;
+        for (r=0; par->restarts && r<par->rounds; r++) {
+            t = gb_now ();
+            probsat_run (ps, 0, 1, par->restarts, (long long)par->seed, &flips, &satisfied, &clauses);
+            t = (gb_now () - t) / par->restarts;
+            if (!r || t < restart) restart = t;
+        }
+        for (r=0; r<par->rounds; r++) {
+            t = gb_now ();
+            probsat_run (ps, 0, par->itrmax, par->triesmax, (long long)par->seed, &flips, &satisfied, &clauses);
+            t = gb_now () - t;
+            if (!r || t < best) best = t;
+        }
+        gb_report (path, "probsat", probsat_kernel (ps), flips, best, restart);
+    }
+    probsat_destroy (ps);
+    return 0;
+}
+/*-----------------------------------------------------------------------------*/
+int main (int argc, char** argv) {
+    gb_params_t par = { 10000, 10, 0.4, 3, 1, 100 };
+    int err=0, i;
+    char opt, *end;
+
+    while ((opt = getopt(argc, argv, "i:T:p:n:r:R:")) != -1) {
+         switch (opt) {
+         case 'i': par.itrmax = par_int_min (argv[0], opt, &err, 1); break;
+         case 'T': par.triesmax = par_int_min (argv[0], opt, &err, 1); break;
+         case 'p': par.p = par_double_rng (argv[0], opt, &err, 0.0, 1.0); break;
+         case 'n': par.rounds = par_int_min (argv[0], opt, &err, 1); break;
+         case 'r': par.seed = strtoull (optarg, &end, 16);           /* hex, as gsat2 -r */
+                   if (*end || !*optarg) { fprintf (stderr, "%s: -r hex number expected\n", argv[0]); err++; }
+                   break;
+         case 'R': par.restarts = par_int_min (argv[0], opt, &err, 0); break;
+         default:  fprintf (stderr, "%s", synopsis);
+                   return EXIT_FAILURE;
+         }
+    }
+    if (err) return EXIT_FAILURE;
+    if (optind == argc) { fprintf (stderr, "%s", synopsis); return EXIT_FAILURE; }
+    printf ("instance solver kernel flips seconds flips/s restart-us\n");
+    for (i=optind; i<argc; i++) {
+        err += gb_gsat (argv[i], &par);
+        err += gb_probsat (argv[i], &par);
+    }
+    return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
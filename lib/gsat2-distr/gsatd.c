@@ -0,0 +1,559 @@
+/*-----------------------------------------------------------------------------*/
+/*   gsatd: gsat2 and probSAT served over a Unix domain socket                 */
+/*   a request is a line of JSON, the reply to it a line of JSON too:          */
+/*   {"id":7,"solver":"gsat","path":"x.cnf","seed":1,"max_flips":300,          */
+/*    "max_tries":1,"p":0.4,"jobs":1}                                          */
+/*   {"id":7,"solved":true,"flips":211,"satisfied":91,"clauses":91,            */
+/*    "cached":false,"ms":0.412}                                               */
+/*   solver "probsat" takes "cb" instead of "p" and "jobs"; a seed is the      */
+/*   number gsat2 -r or probSAT takes, as a JSON number or a string strtoull   */
+/*   reads ("0x55AA55AA55AA55AA"); missing fields take the gsat2 defaults.     */
+/*   {"op":"stats"} and {"op":"shutdown"} report on the cache and stop it;     */
+/*   a request that fails is answered {"id":..,"error":"..."}.                 */
+/*   Instances and their occurrence indexes are kept, least recently used     */
+/*   dropped first, while their path, mtime and size stay the same.           */
+/*-----------------------------------------------------------------------------*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>             /* getopt */
+#include <signal.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "gsat_solver.h"
+#include "num_opts.h"
+
+#include "../probSAT-master/probSAT.h"
+
+/*-----------------------------------------------------------------------------*/
+char synopsis[] = "gsatd <options> socket-path\n"
+"\t-n number                        instances kept, default 16\n"
+"\t-D                               requests and replies to stderr\n"
+;
+
+#define GD_LINE 4096            /* longest reply */
+
+/*-----------------------------------------------------------------------------*/
+/*      a request, as the JSON fields it has                                   */
+/*-----------------------------------------------------------------------------*/
+enum { GD_SOLVE, GD_STATS, GD_SHUTDOWN };
+enum { GD_GSAT, GD_PROBSAT };
+
+typedef struct {
+    char        id[64];         /* raw JSON, echoed; "null" when none */
+    int         op;
+    int         solver;
+    char        path[PATH_MAX];
+    uint64_t    seed;
+    int         has_seed;
+    int         max_flips;      /* per try, 0: no limit */
+    int         max_tries;      /* 0: no limit */
+    int         jobs;
+    double      p;
+    double      cb;             /* probSAT: 0 instance dependent */
+} gd_req_t;
+
+/*-----------------------------------------------------------------------------*/
+/*      the instance cache: gsat handles and probSAT contexts                  */
+/*-----------------------------------------------------------------------------*/
+typedef struct gd_entry {
+    char*           path;
+    int             solver;     /* the same path for both solvers is two entries */
+    struct timespec mtime;
+    off_t           size;
+    gsat_solver_t*  s;
+    probsat_t*      ps;
+    pthread_mutex_t lock;       /* one run at a time on the handle */
+    int             users;      /* requests holding the entry */
+    int             stale;      /* out of the list, freed by the last user */
+    unsigned long long used;    /* tick of the last use */
+    struct gd_entry* next;
+} gd_entry_t;
+
+static struct {
+    pthread_mutex_t lock;
+    gd_entry_t*     head;
+    int             count;
+    int             cap;
+    unsigned long long tick, hits, misses;
+} gd_cache = { PTHREAD_MUTEX_INITIALIZER, NULL, 0, 16, 0, 0, 0 };
+
+
+static gsat_cont_t gd_cont = 1;             /* runs and the server go on, shutdown stops both */
+static struct {                             /* requests being answered, waited for on shutdown */
+    pthread_mutex_t lock;
+    pthread_cond_t  idle;
+    int             busy;
+} gd_busy = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0 };
+static int gd_listen = -1;
+static int gd_debug = 0;
+
+/*-----------------------------------------------------------------------------*/
+/*      JSON: just the flat objects of requests                                */
+/*-----------------------------------------------------------------------------*/
+static const char* gd_ws (const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+    return p;
+}
+/*-----------------------------------------------------------------------------*/
+static int gd_hex4 (const char* p) {
+    int i, v = 0;
+    for (i=0; i<4; i++) {
+        v <<= 4;
+        if (p[i] >= '0' && p[i] <= '9') v |= p[i]-'0';
+        else if (p[i] >= 'a' && p[i] <= 'f') v |= p[i]-'a'+10;
+        else if (p[i] >= 'A' && p[i] <= 'F') v |= p[i]-'A'+10;
+        else return -1;
+    }
+    return v;
+}
+/*-----------------------------------------------------------------------------*/
+/*      a string at p into out, UTF-8; the text after it, NULL on error        */
+/*-----------------------------------------------------------------------------*/
+static const char* gd_string (const char* p, char* out, size_t cap) {
+    size_t n = 0;
+    long c;
+    int lo;
+    if (*p++ != '"') return NULL;
+    while (*p != '"') {
+        if ((unsigned char)*p < 0x20) return NULL;          /* also the end of the line */
+        if (*p != '\\') c = (unsigned char)*p++;
+        else {
+            p++;
+            switch (*p++) {
+            case '"':  c = '"'; break;
+            case '\\': c = '\\'; break;
+            case '/':  c = '/'; break;
+            case 'b':  c = '\b'; break;
+            case 'f':  c = '\f'; break;
+            case 'n':  c = '\n'; break;
+            case 'r':  c = '\r'; break;
+            case 't':  c = '\t'; break;
+            case 'u':  if ((c = gd_hex4 (p)) < 0) return NULL;
+                       p += 4;
+                       if (c >= 0xD800 && c < 0xDC00) {     /* a surrogate pair */
+                           if (p[0] != '\\' || p[1] != 'u' || (lo = gd_hex4 (p+2)) < 0xDC00 || lo >= 0xE000) return NULL;
+                           c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+                           p += 6;
+                       }
+                       if (c == 0) return NULL;
+                       if (c >= 0x80) {                     /* as UTF-8 */
+                           if (n + 4 >= cap) return NULL;
+                           if (c < 0x800) out[n++] = 0xC0 | c >> 6;
+                           else {
+                               if (c < 0x10000) out[n++] = 0xE0 | c >> 12;
+                               else { out[n++] = 0xF0 | c >> 18; out[n++] = 0x80 | (c >> 12 & 0x3F); }
+                               out[n++] = 0x80 | (c >> 6 & 0x3F);
+                           }
+                           c = 0x80 | (c & 0x3F);
+                       }
+                       break;
+            default:   return NULL;
+            }
+        }
+        if (n + 1 >= cap) return NULL;
+        out[n++] = (char)c;
+    }
+    out[n] = 0;
+    return p+1;
+}
+/*-----------------------------------------------------------------------------*/
+/*      past any value at p, NULL on error                                     */
+/*-----------------------------------------------------------------------------*/
+static const char* gd_skip (const char* p) {
+    int depth = 0;
+    char* end;
+    do {
+        p = gd_ws (p);
+        if (*p == '"') {
+            for (p++; *p != '"'; p++) {
+                if ((unsigned char)*p < 0x20) return NULL;
+                if (*p == '\\' && !*++p) return NULL;
+            }
+            p++;
+        } else if (*p == '{' || *p == '[') { depth++; p++; continue; }
+        else if (*p == '}' || *p == ']') { if (--depth < 0) return NULL; p++; }
+        else if (strncmp (p, "true", 4) == 0) p += 4;
+        else if (strncmp (p, "false", 5) == 0) p += 5;
+        else if (strncmp (p, "null", 4) == 0) p += 4;
+        else { strtod (p, &end); if (end == p) return NULL; p = end; }
+        p = gd_ws (p);
+        if (depth > 0 && (*p == ',' || *p == ':')) p++;
+    } while (depth > 0);
+    return p;
+}
+/*-----------------------------------------------------------------------------*/
+static const char* gd_int (const char* p, int* v, const char** msg) {
+    char* end;
+    long l = strtol (p, &end, 10);
+    if (end == p || *end == '.' || *end == 'e' || *end == 'E') { *msg = "an integer expected"; return NULL; }
+    if (l < 0 || l > INT_MAX) { *msg = "a number out of range"; return NULL; }
+    *v = (int)l;
+    return end;
+}
+/*-----------------------------------------------------------------------------*/
+static const char* gd_double (const char* p, double* v) {
+    char* end;
+    *v = strtod (p, &end);
+    return end == p ? NULL : end;
+}
+/*-----------------------------------------------------------------------------*/
+/*      the request in line; 0, or -1 with msg set                             */
+/*-----------------------------------------------------------------------------*/
+static int gd_parse (const char* line, gd_req_t* r, const char** msg) {
+    char key[32], val[32];
+    const char *p = gd_ws (line), *q;
+    char* end;
+
+    memset (r, 0, sizeof *r);
+    strcpy (r->id, "null");
+    r->max_flips = 300;
+    r->max_tries = 1;
+    r->jobs = 1;
+    r->p = 0.4;
+    *msg = "malformed JSON";
+    if (*p++ != '{') { *msg = "a JSON object expected"; return -1; }
+    p = gd_ws (p);
+    if (*p == '}') p++;
+    else for (;;) {
+        if (!(p = gd_string (p, key, sizeof key))) return -1;
+        p = gd_ws (p);
+        if (*p++ != ':') return -1;
+        p = gd_ws (p);
+        if (strcmp (key, "id") == 0) {
+            if (!(q = gd_skip (p))) return -1;
+            while (q > p && (q[-1] == ' ' || q[-1] == '\t' || q[-1] == '\r' || q[-1] == '\n')) q--;
+            if ((size_t)(q - p) >= sizeof r->id) { *msg = "id too long"; return -1; }
+            memcpy (r->id, p, q - p);
+            r->id[q - p] = 0;
+            p = q;
+        } else if (strcmp (key, "op") == 0 || strcmp (key, "solver") == 0) {
+            if (!(p = gd_string (p, val, sizeof val))) { *msg = "unknown op or solver"; return -1; }
+            if (strcmp (val, "solve") == 0) r->op = GD_SOLVE;
+            else if (strcmp (val, "stats") == 0) r->op = GD_STATS;
+            else if (strcmp (val, "shutdown") == 0) r->op = GD_SHUTDOWN;
+            else if (strcmp (val, "gsat") == 0) r->solver = GD_GSAT;
+            else if (strcmp (val, "probsat") == 0) r->solver = GD_PROBSAT;
+            else { *msg = "unknown op or solver"; return -1; }
+        } else if (strcmp (key, "path") == 0) {
+            if (!(p = gd_string (p, r->path, sizeof r->path))) { *msg = "path malformed or too long"; return -1; }
+        } else if (strcmp (key, "seed") == 0) {
+            if (*p == '"') {
+                if (!(p = gd_string (p, val, sizeof val))) { *msg = "seed malformed"; return -1; }
+                errno = 0;
+                r->seed = strtoull (val, &end, 0);
+                if (end == val || *end || errno) { *msg = "seed malformed"; return -1; }
+            } else {
+                errno = 0;
+                r->seed = strtoull (p, &end, 10);
+                if (end == p || *p == '-' || errno || *end == '.' || *end == 'e' || *end == 'E') { *msg = "seed malformed"; return -1; }
+                p = end;
+            }
+            r->has_seed = 1;
+        } else if (strcmp (key, "max_flips") == 0) { if (!(p = gd_int (p, &r->max_flips, msg))) return -1; }
+        else if (strcmp (key, "max_tries") == 0) { if (!(p = gd_int (p, &r->max_tries, msg))) return -1; }
+        else if (strcmp (key, "jobs") == 0) { if (!(p = gd_int (p, &r->jobs, msg))) return -1; }
+        else if (strcmp (key, "p") == 0) { if (!(p = gd_double (p, &r->p))) return -1; }
+        else if (strcmp (key, "cb") == 0) { if (!(p = gd_double (p, &r->cb))) return -1; }
+        else if (!(p = gd_skip (p))) return -1;                    /* unknown fields are let be */
+        p = gd_ws (p);
+        if (*p == '}') { p++; break; }
+        if (*p++ != ',') return -1;
+        p = gd_ws (p);
+    }
+    if (*gd_ws (p)) return -1;
+    if (r->op != GD_SOLVE) return 0;
+    if (!r->path[0]) { *msg = "path missing"; return -1; }
+    if (r->p < 0.0 || r->p > 1.0) { *msg = "p must lie in 0..1"; return -1; }
+    if (r->cb < 0.0) { *msg = "cb must not be negative"; return -1; }
+    if (r->jobs < 1) { *msg = "jobs must be positive"; return -1; }
+    return 0;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*      the cache                                                              */
+/*-----------------------------------------------------------------------------*/
+static gd_entry_t* gd_entry_forget (gd_entry_t* e) {
+    if (!e) return NULL;
+    gsat_destroy (e->s);
+    probsat_destroy (e->ps);
+    pthread_mutex_destroy (&e->lock);
+    free (e->path);
+    free (e);
+    return NULL;
+}
+/*-----------------------------------------------------------------------------*/
+static int gd_same (const struct stat* st, const struct timespec* mtime, off_t size) {
+    return st->st_mtim.tv_sec == mtime->tv_sec && st->st_mtim.tv_nsec == mtime->tv_nsec && st->st_size == size;
+}
+/*-----------------------------------------------------------------------------*/
+/*      out of the list; freed at once unless in use (cache lock held)         */
+/*-----------------------------------------------------------------------------*/
+static void gd_cache_drop (gd_entry_t** pe) {
+    gd_entry_t* e = *pe;
+    *pe = e->next;
+    gd_cache.count--;
+    if (e->users) e->stale = 1;
+    else gd_entry_forget (e);
+}
+/*-----------------------------------------------------------------------------*/
+/*      the entry of path for solver, read when not kept; NULL with err set   */
+/*-----------------------------------------------------------------------------*/
+static gd_entry_t* gd_cache_get (const char* path, int solver, int* cached, int* err) {
+    struct stat st;
+    gd_entry_t *e, *f, **pe, **lru;
+    inst_t inst;
+    FILE* in;
+
+    if (stat (path, &st) != 0) { *err = errno; return NULL; }
+    pthread_mutex_lock (&gd_cache.lock);
+    for (pe = &gd_cache.head; (e = *pe); pe = &e->next) if (e->solver == solver && strcmp (e->path, path) == 0) break;
+    if (e && gd_same (&st, &e->mtime, e->size)) {
+        e->users++;
+        e->used = ++gd_cache.tick;
+        gd_cache.hits++;
+        pthread_mutex_unlock (&gd_cache.lock);
+        *cached = 1;
+        return e;
+    }
+    if (e) gd_cache_drop (pe);                                  /* the file changed */
+    gd_cache.misses++;
+    pthread_mutex_unlock (&gd_cache.lock);
+    *cached = 0;
+
+    /* ----------------------- read it, unlocked -------------- */
+    if (!(e = calloc (1, sizeof *e)) || !(e->path = strdup (path))) {
+        free (e);
+        *err = ERR_ALLOC;
+        return NULL;
+    }
+    pthread_mutex_init (&e->lock, NULL);
+    e->solver = solver;
+    if (solver == GD_PROBSAT) {
+        if (!(e->ps = probsat_create (path))) { *err = ERR_FORMAT; return gd_entry_forget (e); }
+        probsat_set_cont (e->ps, &gd_cont);
+    } else {
+        if (!(in = fopen (path, "rb"))) { *err = errno; return gd_entry_forget (e); }
+        *err = inst_read (&inst, in, 0);
+        fclose (in);
+        if (*err) return gd_entry_forget (e);
+        if (!(e->s = gsat_create (&inst))) { inst_forget (&inst); *err = ERR_ALLOC; return gd_entry_forget (e); }
+        gsat_set_cont (e->s, &gd_cont);
+    }
+    e->mtime = st.st_mtim;
+    e->size = st.st_size;
+    e->users = 1;
+
+    /* ----------------------- into the list ------------------ */
+    pthread_mutex_lock (&gd_cache.lock);
+    for (pe = &gd_cache.head; (f = *pe); pe = &f->next) if (f->solver == solver && strcmp (f->path, path) == 0) break;
+    if (f) gd_cache_drop (pe);                                  /* read meanwhile by another request */
+    e->used = ++gd_cache.tick;
+    e->next = gd_cache.head;
+    gd_cache.head = e;
+    gd_cache.count++;
+    while (gd_cache.count > gd_cache.cap) {                     /* the least recently used, not in use */
+        lru = NULL;
+        for (pe = &gd_cache.head; (f = *pe); pe = &f->next)
+            if (!f->users && (!lru || f->used < (*lru)->used)) lru = pe;
+        if (!lru) break;
+        gd_cache_drop (lru);
+    }
+    pthread_mutex_unlock (&gd_cache.lock);
+    return e;
+}
+/*-----------------------------------------------------------------------------*/
+static void gd_cache_put (gd_entry_t* e) {
+    pthread_mutex_lock (&gd_cache.lock);
+    if (--e->users == 0 && e->stale) gd_entry_forget (e);
+    pthread_mutex_unlock (&gd_cache.lock);
+}
+
+/*-----------------------------------------------------------------------------*/
+/*      the solvers; 1 satisfied, 0 not, or an error as inst_read's, errno    */
+/*-----------------------------------------------------------------------------*/
+static int gd_run_gsat (const gd_req_t* r, long long* flips, int* satisfied, int* clauses, int* cached) {
+    gd_entry_t* e;
+    int err, rtn;
+
+    if (!(e = gd_cache_get (r->path, GD_GSAT, cached, &err))) return err;
+    pthread_mutex_lock (&e->lock);
+    gsat_set_p (e->s, r->p);
+    gsat_set_itrmax (e->s, r->max_flips);
+    gsat_set_triesmax (e->s, r->max_tries);
+    gsat_set_jobs (e->s, r->jobs);
+    gsat_set_seed (e->s, r->has_seed ? r->seed : GSAT_DEFAULT_SEED);   /* as gsat2 -r */
+    rtn = gsat_run (e->s, 0, 0);
+    *flips = gsat_flips (e->s);
+    *satisfied = gsat_satisfied (e->s);
+    *clauses = gsat_inst (e->s)->length;
+    pthread_mutex_unlock (&e->lock);
+    gd_cache_put (e);
+    return rtn;
+}
+/*-----------------------------------------------------------------------------*/
+static int gd_run_probsat (const gd_req_t* r, long long* flips, int* satisfied, int* clauses, int* cached) {
+    long long tries = r->max_tries ? r->max_tries : LLONG_MAX;
+    long long flipmax = r->max_flips ? r->max_flips : LLONG_MAX;
+    gd_entry_t* e;
+    int err, rtn;
+
+    if (!(e = gd_cache_get (r->path, GD_PROBSAT, cached, &err))) return err;
+    pthread_mutex_lock (&e->lock);
+    rtn = probsat_run (e->ps, r->cb, flipmax, tries, (long long)(r->has_seed ? r->seed : GSAT_DEFAULT_SEED),
+                       flips, satisfied, clauses);                    /* the seed gsat gets */
+    pthread_mutex_unlock (&e->lock);
+    gd_cache_put (e);
+    return rtn;
+}
+/*-----------------------------------------------------------------------------*/
+/*      the reply to a line into out                                           */
+/*-----------------------------------------------------------------------------*/
+static void gd_error (char* out, const char* id, const char* msg, const char* path) {
+    snprintf (out, GD_LINE, "{\"id\":%s,\"error\":\"%s%s%s\"}\n", id, path ? path : "", path ? ": " : "", msg);
+}
+/*-----------------------------------------------------------------------------*/
+static void gd_answer (const char* line, char* out) {
+    gd_req_t r;
+    struct timespec t0, t1;
+    long long flips = 0;
+    int satisfied = 0, clauses = 0, cached = 0, rtn;
+    const char* msg;
+    char path[256];
+    size_t n;
+
+    if (gd_parse (line, &r, &msg) != 0) { gd_error (out, r.id, msg, NULL); return; }
+    switch (r.op) {
+    case GD_STATS:
+        pthread_mutex_lock (&gd_cache.lock);
+        snprintf (out, GD_LINE, "{\"id\":%s,\"entries\":%d,\"capacity\":%d,\"hits\":%llu,\"misses\":%llu}\n",
+                  r.id, gd_cache.count, gd_cache.cap, gd_cache.hits, gd_cache.misses);
+        pthread_mutex_unlock (&gd_cache.lock);
+        return;
+    case GD_SHUTDOWN:
+        gd_cont = 0;                                            /* runs stop, the listener is shut once replied */
+        snprintf (out, GD_LINE, "{\"id\":%s,\"shutdown\":true}\n", r.id);
+        return;
+    }
+    clock_gettime (CLOCK_MONOTONIC, &t0);
+    if (r.solver == GD_GSAT) rtn = gd_run_gsat (&r, &flips, &satisfied, &clauses, &cached);
+    else rtn = gd_run_probsat (&r, &flips, &satisfied, &clauses, &cached);
+    clock_gettime (CLOCK_MONOTONIC, &t1);
+    if (rtn != 0 && rtn != 1) {
+        for (n=0; r.path[n] && n < sizeof path - 1; n++)         /* as a JSON string */
+            path[n] = (r.path[n] == '"' || r.path[n] == '\\' || (unsigned char)r.path[n] < 0x20) ? '?' : r.path[n];
+        path[n] = 0;
+        if (rtn > 0) gd_error (out, r.id, strerror (rtn), path);
+        else if (rtn == ERR_ALLOC) gd_error (out, r.id, "out of memory", path);
+        else gd_error (out, r.id, "not a readable CNF instance", path);
+        return;
+    }
+    snprintf (out, GD_LINE, "{\"id\":%s,\"solved\":%s,\"flips\":%lld,\"satisfied\":%d,\"clauses\":%d,"
+              "\"cached\":%s,\"ms\":%.3f}\n", r.id, rtn ? "true" : "false", flips, satisfied, clauses,
+              cached ? "true" : "false", (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+}
+
+/*-----------------------------------------------------------------------------*/
+/*      a connection: requests answered in turn until it closes                */
+/*-----------------------------------------------------------------------------*/
+static void* gd_serve (void* arg) {
+    int fd = (int)(intptr_t)arg;
+    FILE* in = fdopen (fd, "r");
+    char* line = NULL;
+    size_t cap = 0, len, done;
+    ssize_t n;
+    char out[GD_LINE];
+
+    if (!in) { close (fd); return NULL; }
+    while (gd_cont && getline (&line, &cap, in) > 0) {
+        if (!*gd_ws (line)) continue;                           /* blank lines */
+        pthread_mutex_lock (&gd_busy.lock);
+        gd_busy.busy++;
+        pthread_mutex_unlock (&gd_busy.lock);
+        gd_answer (line, out);
+        if (gd_debug) fprintf (stderr, "< %s> %s", line, out);
+        len = strlen (out);
+        for (done = 0; done < len; done += n)
+            if ((n = write (fd, out + done, len - done)) < 0 && errno != EINTR) break;
+            else if (n < 0) n = 0;
+        pthread_mutex_lock (&gd_busy.lock);
+        if (!--gd_busy.busy) pthread_cond_broadcast (&gd_busy.idle);
+        pthread_mutex_unlock (&gd_busy.lock);
+        if (done < len) break;
+    }
+    if (!gd_cont) shutdown (gd_listen, SHUT_RDWR);              /* accept returns */
+    free (line);
+    fclose (in);
+    return NULL;
+}
+/*-----------------------------------------------------------------------------*/
+static void gd_handler (int signo) {
+    gd_cont = 0;
+    shutdown (gd_listen, SHUT_RDWR);
+}
+
+/*-----------------------------------------------------------------------------*/
+int main (int argc, char** argv) {
+    struct sockaddr_un addr;
+    struct sigaction act;
+    pthread_attr_t attr;
+    pthread_t th;
+    int err=0, fd;
+    char opt;
+
+    /* ---------------------- options ----------------------- */
+    while ((opt = getopt(argc, argv, "n:D")) != -1) {
+         switch (opt) {
+         case 'n': gd_cache.cap = par_int_min (argv[0], opt, &err, 1); break;
+         case 'D': gd_debug=1; break;
+         default:  fprintf (stderr, "%s", synopsis);
+                   return EXIT_FAILURE;
+         }
+    }
+    if (optind != argc-1) { fprintf (stderr, "%s", synopsis); return EXIT_FAILURE; }
+    if (err) return EXIT_FAILURE;
+    if (strlen (argv[optind]) >= sizeof addr.sun_path) {
+        fprintf (stderr, "%s: socket path too long\n", argv[0]); return EXIT_FAILURE;
+    }
+
+    /* ----------------------- the socket -------------------- */
+    memset (&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    strcpy (addr.sun_path, argv[optind]);
+    if ((gd_listen = socket (AF_UNIX, SOCK_STREAM, 0)) < 0
+        || bind (gd_listen, (struct sockaddr*)&addr, sizeof addr) != 0
+        || listen (gd_listen, 16) != 0) {
+        fprintf (stderr, "%s: %s: %s\n", argv[0], argv[optind], strerror (errno)); return EXIT_FAILURE;
+    }
+
+    /* -------- CTRL-C and kill stop accepting, not restarted ------ */
+    memset (&act, 0, sizeof act);
+    act.sa_handler = &gd_handler;
+    sigaction (SIGINT, &act, NULL);
+    sigaction (SIGTERM, &act, NULL);
+    signal (SIGPIPE, SIG_IGN);                                  /* a client gone is a failed write */
+
+    /* ----------------------- connections ------------------- */
+    pthread_attr_init (&attr);
+    pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+    while (gd_cont) {
+        if ((fd = accept (gd_listen, NULL, NULL)) < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        if (pthread_create (&th, &attr, gd_serve, (void*)(intptr_t)fd) != 0) gd_serve ((void*)(intptr_t)fd);
+    }
+    pthread_attr_destroy (&attr);
+    pthread_mutex_lock (&gd_busy.lock);                         /* the runs stopped, their replies out */
+    while (gd_busy.busy) pthread_cond_wait (&gd_busy.idle, &gd_busy.lock);
+    pthread_mutex_unlock (&gd_busy.lock);
+    close (gd_listen);
+    unlink (argv[optind]);
+    return EXIT_SUCCESS;
+}
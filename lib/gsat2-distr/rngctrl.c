@@ -40,11 +40,8 @@ int gettimeofday(struct timeval* tp, struct timezone* tzp)
 
 #include "rngctrl.h"
 
-/* options */
-char* endsts = NULL;		/* filename to write RNG state at the end */
-char* begsts = NULL;		/* filename to write RNG state at the beginning */
-rng_seed_t  rng_seed;  int rng_seed_given = 0;
-rng_state_t rng_state; int rng_state_given = 0;
+/* options of the plain functions */
+static rng_ctrl_t ctrl = RNG_CTRL_INIT;
 
 int rng_seed_time (rng_seed_t* pseed) {
     struct timeval tv;
@@ -58,25 +55,25 @@ int rng_seed_time (rng_seed_t* pseed) {
     return 0;
 }
 
-int rng_options (int opt, char* optarg, char* prog) {
+int rng_options_r (rng_ctrl_t* pc, int opt, char* optarg, char* prog) {
     int rtn, err=0;
     FILE* in;
 
     switch (opt) {
 
     case 'r': 						            /* RNG seed */
-        rtn = rng_seed_deseri (optarg, &rng_seed);	/* can be interpreted as seed */
+        rtn = rng_seed_deseri (optarg, &pc->seed);	/* can be interpreted as seed */
         if (rtn) {
-            rng_seed_given = 1;
+            pc->seed_given = 1;
             break; 
         }
         if (strcmp ("time", optarg) == 0) { 	/* given the time keyword */
-            rtn = rng_seed_time(&rng_seed);
+            rtn = rng_seed_time(&pc->seed);
             if (rtn < 0) {
                  perror ("time");
                  err++;
             } 
-            rng_seed_given = 1;
+            pc->seed_given = 1;
             break; 
         }
         in = fopen (optarg, "r");               /* must be filename */
@@ -85,18 +82,18 @@ int rng_options (int opt, char* optarg, char* prog) {
             err++; 
             break;
         }
-        rtn = rng_seed_read (in, &rng_seed);
+        rtn = rng_seed_read (in, &pc->seed);
         if (!rtn) { 
             fprintf (stderr, "%s: RNG seed in %s incorrect\n", prog, optarg); 
             err++;
             break; 
         }
         fclose (in);
-        rng_seed_given = 1;
+        pc->seed_given = 1;
         break;
 
     case 'R':                                   /* RNG status given */
-        rtn = rng_state_deseri(optarg, &rng_state);     /* is of the correct format */
+        rtn = rng_state_deseri(optarg, &pc->state);     /* is of the correct format */
         if (!rtn) {
             in = fopen (optarg, "r");			/* must be filename */
             if (!in) { 
@@ -104,20 +101,20 @@ int rng_options (int opt, char* optarg, char* prog) {
                 err++; 
                 break;
 	        }
-            rtn = rng_state_read (in, &rng_state);
+            rtn = rng_state_read (in, &pc->state);
             if (!rtn || rtn==EOF) { 
                 fprintf (stderr, "%s: RNG status in %s incorrect\n", prog, optarg); 
                 err++; 
             }
             fclose (in);
         }
-        rng_state_given = 1;
+        pc->state_given = 1;
         break;
          
-    case 's': begsts = optarg;				/* save status at the beginning */
+    case 's': pc->begsts = optarg;				/* save status at the beginning */
         break;
 
-    case 'S': endsts = optarg;				/* save status at the end */
+    case 'S': pc->endsts = optarg;				/* save status at the end */
         break;
 
     default: return -1;
@@ -125,50 +122,57 @@ int rng_options (int opt, char* optarg, char* prog) {
     
     return err;     /* 0..OK, >0: errors, <0: unknown parameter */
 }
+int rng_options (int opt, char* optarg, char* prog) {
+    return rng_options_r (&ctrl, opt, optarg, prog);
+}
 
 #define DEFAULT_SEED 0x55AA55AA55AA55AAULL
 
-int rng_apply_options (char* prog) {
+int rng_apply_options_r (rng_ctrl_t* pc, char* prog, rng_state_t* ps) {
     FILE* out; int err=0;
-    rng_state_t state;
+    (void)prog;                                 /* perror names the file */
 
-    if (rng_state_given) {       			/* if given, state has priority */
-        rng_set_state (&rng_state);
-    } else if (rng_seed_given) {    			/* else seed given */
-        rng_set_seed (rng_seed);
+    if (pc->state_given) {       			/* if given, state has priority */
+        *ps = pc->state;
+    } else if (pc->seed_given) {    			/* else seed given */
+        rng_set_seed_r (ps, pc->seed);
     } else {
-        rng_set_seed (DEFAULT_SEED);         		/* else a constant seed as usual */ 
+        rng_set_seed_r (ps, DEFAULT_SEED);         	/* else a constant seed as usual */ 
     }
     
-    if (begsts) {
-        out = fopen (begsts, "w");
+    if (pc->begsts) {
+        out = fopen (pc->begsts, "w");
         if (!out) { 
-            perror (begsts); err++; 
+            perror (pc->begsts); err++; 
         } else {
-            rng_get_state(&state);
-            rng_state_write(out, &state); 
+            rng_state_write(out, ps); 
             fclose(out);
         }
     }      
     return (err == 0);
 }
+int rng_apply_options (char* prog) {
+    return rng_apply_options_r (&ctrl, prog, rng_global());
+}
 
-int rng_end_options (char* prog) {
+int rng_end_options_r (rng_ctrl_t* pc, char* prog, rng_state_t* ps) {
     FILE* out; int err=0;
-    rng_state_t state;
+    (void)prog;                                 /* perror names the file */
     
-    if (endsts) {
-        out = fopen (endsts, "w");
+    if (pc->endsts) {
+        out = fopen (pc->endsts, "w");
         if (!out) { 
-            perror (endsts); err++; 
+            perror (pc->endsts); err++; 
         } else {
-            rng_get_state(&state);
-            rng_state_write(out, &state); 
+            rng_state_write(out, ps); 
             fclose(out);
         }
     }      
     return (err == 0);
 }
+int rng_end_options (char* prog) {
+    return rng_end_options_r (&ctrl, prog, rng_global());
+}
 
 char rng_synopsis[]=
 "\tRNG control\n"
@@ -4,9 +4,22 @@
 #include "xoshiro256plus.h"
 #define RNG_OPTS "r:R:s:S:"
 
+/* the options given, for the _r functions; the plain ones keep their own */
+/* and apply them to the global RNG state */
+typedef struct {
+    char* endsts;               /* filename to write RNG state at the end */
+    char* begsts;               /* filename to write RNG state at the beginning */
+    rng_seed_t  seed;  int seed_given;
+    rng_state_t state; int state_given;
+} rng_ctrl_t;
+#define RNG_CTRL_INIT { NULL, NULL, 0, 0, {{0, 0, 0, 0}}, 0 }
+
 int rng_options (int opt, char* optarg, char* prog);
 int rng_apply_options (char* prog);
 int rng_end_options (char* prog);
+int rng_options_r (rng_ctrl_t* pc, int opt, char* optarg, char* prog);
+int rng_apply_options_r (rng_ctrl_t* pc, char* prog, rng_state_t* ps);
+int rng_end_options_r (rng_ctrl_t* pc, char* prog, rng_state_t* ps);
 extern char rng_synopsis[];
 
 #endif
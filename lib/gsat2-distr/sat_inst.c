@@ -1,121 +1,330 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#ifndef _MSC_VER
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>       /* mmap */
+#endif
 
 #include "sat_inst.h"
 #ifdef _MSC_VER
 #define strcasecmp _stricmp
 #endif
 
+#define BLOCK (1<<20)       /* read size for pipes */
 
-literal_t* inst_reserve (int clause_no, int clause_w) {
-    return calloc (clause_no*clause_w, sizeof(literal_t));
+literal_t* inst_reserve (int lits_no) {
+    return malloc ((lits_no > 0 ? lits_no : 1) * sizeof(literal_t));
 }
 
 void inst_forget (inst_t* inst) {
     inst->vars_no=0;
     inst->length=0;
     inst->width=0;
-    free (inst->body);
-}
-
-int inst_width (inst_t* inst, FILE* dimacs) {
-    char c; int rtn; char problem[8] = "";
-    int i,j; literal_t* clause; int lit;
-    int width = 0;
-    
-    c = fgetc(dimacs);
-    while (c != EOF) {
-        switch (c) {
-        case 'c':
-        case 'C': while ((c = fgetc(dimacs)) != EOF && c != '\n') {}; break;
-        case 'p':
-        case 'P': if ((rtn = fscanf(dimacs," %s8", problem)) == EOF) return ERR_FORMAT;
-                  if (strcasecmp (problem, "cnf") != 0) return ERR_PROBLEM;
-                  if ((rtn = fscanf(dimacs," %d", &(inst->vars_no)))  == EOF || rtn == 0) return ERR_FORMAT;
-                  if ((rtn = fscanf(dimacs," %d", &(inst->length)))  == EOF || rtn == 0) return ERR_FORMAT;
-                  break;
-        case '\n': break;
-        default:  ungetc (c, dimacs); c = EOF; break;
+    inst->lits_no=0;
+    if (inst->map) {
+#ifndef _MSC_VER
+        if (inst->map_size) munmap (inst->map, inst->map_size); else
+#endif
+        free (inst->map);
+    } else if (!inst->shared) {
+        free (inst->body);
+        free (inst->start);
+    }
+    inst->body=NULL;
+    inst->start=NULL;
+    inst->occ_ix=NULL;
+    inst->occ=NULL;
+    inst->map=NULL;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  the whole input text, mapped if it is a regular file, read in blocks else  */
+/*-----------------------------------------------------------------------------*/
+typedef struct {
+    char* text;
+    size_t size;
+    void* map;          /* mapping to release, text is in it */
+    size_t map_size;
+} inst_text_t;
+
+static int text_get (inst_text_t* t, FILE* dimacs) {
+    size_t cap, got;
+    char* more;
+#ifndef _MSC_VER
+    struct stat st;
+    long pos = ftell (dimacs);
+    t->map = NULL;
+    if (pos >= 0 && fstat (fileno (dimacs), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > pos) {
+        t->map_size = st.st_size;
+        t->map = mmap (NULL, t->map_size, PROT_READ, MAP_PRIVATE, fileno (dimacs), 0);
+        if (t->map != MAP_FAILED) {
+            t->text = (char*)t->map + pos;                  /* the stream may have been read already */
+            t->size = t->map_size - pos;
+            return 0;
         }
-        if (c != EOF) c = fgetc(dimacs);
-    }			/* header done */
-
-    if (problem[0]==0)  return ERR_FORMAT;	/* problem not given at all */
-    for (i=0, clause=inst->body; i<inst->length; i++, clause+=inst->width) {
-        j=0;
-        rtn = fscanf(dimacs, " %d", &lit);	/* next line */
-        if (rtn == EOF)  return ERR_FORMAT;	/* too few clauses */
-        while (rtn != EOF && lit != 0) {
-            j++;
-            rtn = fscanf(dimacs, " %d", &lit);
+        t->map = NULL;
+    }
+#else
+    t->map = NULL;
+#endif
+    t->map_size = 0;
+    t->size = 0;
+    cap = BLOCK;
+    if (!(t->text = malloc (cap))) return ERR_ALLOC;
+    while ((got = fread (t->text + t->size, 1, cap - t->size, dimacs)) > 0) {
+        t->size += got;
+        if (t->size == cap) {
+            if (!(more = realloc (t->text, 2*cap))) { free (t->text); return ERR_ALLOC; }
+            t->text = more;
+            cap *= 2;
         }
-        if (j > width) width = j;
     }
-    return width;
+    return 0;
 }
 
-int inst_read (inst_t* inst, FILE* dimacs, int clause_w) {
-    char c; int rtn; char problem[8] = "";
-    int i,j; literal_t* clause; int lit;
-    
-    inst->width = clause_w;
-    c = fgetc(dimacs);
-    while (c != EOF) {
-        switch (c) {
-        case 'c':
-        case 'C': while ((c = fgetc(dimacs)) != EOF && c != '\n') {}; break;
-        case 'p':
-        case 'P': if ((rtn = fscanf(dimacs," %s8", problem)) == EOF) return ERR_FORMAT;
-                  if (strcasecmp (problem, "cnf") != 0) return ERR_PROBLEM;
-                  if ((rtn = fscanf(dimacs," %d", &(inst->vars_no)))  == EOF || rtn == 0) return ERR_FORMAT;
-                  if ((rtn = fscanf(dimacs," %d", &(inst->length)))  == EOF || rtn == 0) return ERR_FORMAT;
-                  break;
-        case '\n': break;
-        default:  ungetc (c, dimacs); c = EOF; break;
-        }
-        if (c != EOF) c = fgetc(dimacs);
-    }			/* header done */
-    if (problem[0]==0)  return ERR_FORMAT;	/* problem not given at all */
-    inst->width = clause_w;
-    inst->body = inst_reserve(inst->length, inst->width);
-    if (!inst->body) return ERR_ALLOC;
-    
-    for (i=0, clause=inst->body; i<inst->length; i++, clause+=inst->width) {
-        j=0;
-        rtn = fscanf(dimacs, " %d", &lit); 
-        if (rtn == EOF)  return ERR_FORMAT;	                /* too few clauses */
-        while (rtn != EOF && lit != 0 && j<inst->width) {
-            clause[j]=lit;
-            j++;
-            rtn = fscanf(dimacs, " %d", &lit);
+static void text_release (inst_text_t* t) {
+#ifndef _MSC_VER
+    if (t->map) { munmap (t->map, t->map_size); return; }
+#endif
+    free (t->text);
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  scanner over the text, p is the position, e the end                        */
+/*-----------------------------------------------------------------------------*/
+static inline const char* skip_space (const char* p, const char* e) {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    return p;
+}
+static inline const char* skip_line (const char* p, const char* e) {
+    while (p < e && *p != '\n') p++;
+    return p;
+}
+static inline const char* scan_int (const char* p, const char* e, int* val) {    /* NULL if no number */
+    int neg = 0, v = 0;
+    const char* d;
+    if (p < e && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    for (d = p; p < e && *p >= '0' && *p <= '9'; p++) v = 10*v + (*p - '0');
+    if (p == d) return NULL;
+    *val = neg ? -v : v;
+    return p;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  read a DIMACS CNF in one pass; clause_w limits the clause length, 0 means  */
+/*  no limit; the clauses are sized on the fly                                 */
+/*-----------------------------------------------------------------------------*/
+static int inst_parse (inst_t* inst, const char* p, const char* e, int clause_w) {
+    char problem[8]; int k, i, j, lit, cap;
+    literal_t* more;
+
+    for (;;) {                                          /* header */
+        p = skip_space (p, e);
+        if (p == e) return ERR_FORMAT;                  /* problem not given at all */
+        if (*p == 'c' || *p == 'C') { p = skip_line (p, e); continue; }
+        if (*p != 'p' && *p != 'P') return ERR_FORMAT;
+        p = skip_space (p+1, e);
+        for (k=0; p < e && k < 7 && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r'; k++) problem[k] = *p++;
+        problem[k] = 0;
+        if (strcasecmp (problem, "cnf") != 0) return ERR_PROBLEM;
+        if (!(p = scan_int (skip_space (p, e), e, &inst->vars_no))) return ERR_FORMAT;
+        if (!(p = scan_int (skip_space (p, e), e, &inst->length))) return ERR_FORMAT;
+        break;
+    }
+    if (inst->vars_no < 0 || inst->length < 0) return ERR_FORMAT;
+
+    cap = 3*inst->length;                               /* a guess, grows as needed */
+    inst->body = inst_reserve (cap);
+    inst->start = calloc (inst->length+1, sizeof(int));
+    if (!inst->body || !inst->start) return ERR_ALLOC;
+
+    for (i=0, j=0; i<inst->length; i++) {
+        inst->start[i] = j;
+        for (;;) {
+            p = skip_space (p, e);
+            if (p < e && (*p == 'c' || *p == 'C')) { p = skip_line (p, e); continue; }
+            if (!(p = scan_int (p, e, &lit))) return ERR_FORMAT;       /* too few clauses */
+            if (lit == 0) break;
+            if (lit > inst->vars_no || -lit > inst->vars_no) return ERR_FORMAT;
+            if (clause_w && j - inst->start[i] == clause_w) return ERR_WIDTH;
+            if (j == cap) {
+                if (!(more = realloc (inst->body, 2*cap*sizeof(literal_t)))) return ERR_ALLOC;
+                inst->body = more;
+                cap *= 2;
+            }
+            inst->body[j++] = lit;
         }
-        if (j==inst->width && lit !=0) return ERR_WIDTH;
+        if (j - inst->start[i] > inst->width) inst->width = j - inst->start[i];
     }
+    inst->lits_no = inst->start[inst->length] = j;
+    if ((more = realloc (inst->body, (j ? j : 1) * sizeof(literal_t)))) inst->body = more;
     return 0;
 }
 
+/*-----------------------------------------------------------------------------*/
+/*  take a binary instance over, the sections are used where they are          */
+/*-----------------------------------------------------------------------------*/
+static int inst_bin_check (size_t size, uint64_t at, uint64_t items) {
+    return at % sizeof(int32_t) == 0 && at >= sizeof(inst_bin_t) && at <= size && items <= (size-at)/sizeof(int32_t);
+}
+/*-----------------------------------------------------------------------------*/
+/*  the contents too, all the search may index by: literals of known           */
+/*  variables, clause starts and the occurrence index ascending and spanning   */
+/*  the literals, occurrences of existing clauses, the width the longest one   */
+/*-----------------------------------------------------------------------------*/
+static int inst_bin_ascending (const int32_t* a, int64_t items, int32_t first, int32_t last) {
+    int64_t i;
+    if (a[0] != first || a[items-1] != last) return 0;
+    for (i=1; i<items; i++) if (a[i] < a[i-1]) return 0;
+    return 1;
+}
+static int inst_bin_valid (inst_bin_t* h, const char* text) {
+    const int32_t* body = (const int32_t*)(text + h->body);
+    const int32_t* start = (const int32_t*)(text + h->start);
+    const int32_t* occ = (const int32_t*)(text + h->occ);
+    int32_t i, w = 0;
+    for (i=0; i<h->lits_no; i++) {
+        if (!body[i] || body[i] > h->vars_no || -body[i] > h->vars_no) return 0;
+        if ((uint32_t)occ[i] >= (uint32_t)h->length) return 0;
+    }
+    if (!inst_bin_ascending (start, (int64_t)h->length+1, 0, h->lits_no)) return 0;
+    if (!inst_bin_ascending ((const int32_t*)(text + h->occ_ix), 2*(int64_t)h->vars_no+2, 0, h->lits_no)) return 0;
+    for (i=0; i<h->length; i++) if (start[i+1]-start[i] > w) w = start[i+1]-start[i];
+    return w == h->width;
+}
+static int inst_bin_take (inst_t* inst, inst_text_t* t, int clause_w) {
+    inst_bin_t* h = (inst_bin_t*)t->text;
+    int n;
+    if (h->version != INST_BIN_VERSION || h->order != INST_BIN_ORDER) return ERR_BINARY;
+    if (h->vars_no < 0 || h->length < 0 || h->lits_no < 0) return ERR_FORMAT;
+    n = h->vars_no;
+    if (!inst_bin_check (t->size, h->body, h->lits_no) || !inst_bin_check (t->size, h->start, (uint64_t)h->length+1)
+     || !inst_bin_check (t->size, h->occ_ix, 2*(uint64_t)n+2) || !inst_bin_check (t->size, h->occ, h->lits_no)) return ERR_FORMAT;
+    if (!inst_bin_valid (h, t->text)) return ERR_FORMAT;
+    if (clause_w && h->width > clause_w) return ERR_WIDTH;
+    inst->vars_no = n;
+    inst->length = h->length;
+    inst->width = h->width;
+    inst->lits_no = h->lits_no;
+    inst->body = (literal_t*)(t->text + h->body);
+    inst->start = (int*)(t->text + h->start);
+    inst->occ_ix = (int*)(t->text + h->occ_ix) + n;
+    inst->occ = (int*)(t->text + h->occ);
+    inst->shared = 1;
+    inst->map = t->map ? t->map : t->text;
+    inst->map_size = t->map ? t->map_size : 0;
+    return 0;
+}
+
+int inst_read (inst_t* inst, FILE* dimacs, int clause_w) {
+    inst_text_t text;
+    int err;
+
+    inst->vars_no = inst->length = inst->width = inst->lits_no = 0;
+    inst->body = NULL;
+    inst->start = NULL;
+    inst->shared = 0;
+    inst->occ_ix = inst->occ = NULL;
+    inst->map = NULL;
+    if ((err = text_get (&text, dimacs))) return err;
+    if (text.size >= sizeof(inst_bin_t) && memcmp (text.text, INST_BIN_MAGIC, sizeof(INST_BIN_MAGIC)) == 0) {
+        if ((err = inst_bin_take (inst, &text, clause_w))) text_release (&text);
+        return err;                                     /* the text stays as the instance */
+    }
+    err = inst_parse (inst, text.text, text.text+text.size, clause_w);
+    text_release (&text);
+    if (err) inst_forget (inst);
+    return err;
+}
+
+/*-----------------------------------------------------------------------------*/
+/*  the clauses where each literal occurs, by counting sort                    */
+/*-----------------------------------------------------------------------------*/
+void inst_occ_fill (inst_t* inst, int* occ_ix, int* occ) {
+    int i, l, n = inst->vars_no;
+    for (i=0; i<inst->lits_no; i++) {                   /* occurrences of each literal, shifted by one */
+        occ_ix[inst->body[i]+1]++;
+    }
+    for (l=-n+1; l<=n+1; l++) occ_ix[l] += occ_ix[l-1]; /* where the lists begin */
+    for (i=0; i<inst->length; i++) {
+        for (l=inst->start[i]; l<inst->start[i+1]; l++) {
+            occ[occ_ix[inst->body[l]]++] = i;
+        }
+    }
+    for (l=n+1; l>-n; l--) occ_ix[l] = occ_ix[l-1];     /* the fill moved them by a list */
+    occ_ix[-n] = 0;
+}
+
 void inst_read_fail (int err, const char* prog) {
     switch (err) {
     case ERR_PROBLEM: fprintf (stderr, "%s: problem type not a CNF\n", prog); break;
     case ERR_FORMAT:  fprintf (stderr, "%s: input not in DIMACS file format\n", prog); break;
     case ERR_WIDTH:   fprintf (stderr, "%s: clause width exceeded\n", prog); break;
     case ERR_ALLOC:   fprintf (stderr, "%s: allocation failure\n", prog); break;
+    case ERR_BINARY:  fprintf (stderr, "%s: binary instance of another version or byte order\n", prog); break;
     default:          fprintf (stderr, "%s: data input failure (%d)\n", prog, err);break;
     }
 }
 
 int inst_write (inst_t* inst, FILE* dimacs) {
-    int i,j; literal_t* clause; 
+    int i,j; 
     fprintf(dimacs,"p cnf %d %d\n", inst->vars_no, inst->length);
     fprintf(dimacs,"c width %d\n", inst->width);
-    for (i=0, clause=inst->body; i<inst->length; i++, clause+=inst->width) {
-        j=0;    
-        while (j<inst->width && clause[j] != 0) {
-            fprintf(dimacs, "%d ", clause[j]);
-            j++;
+    for (i=0; i<inst->length; i++) {
+        for (j=inst->start[i]; j<inst->start[i+1]; j++) {
+            fprintf(dimacs, "%d ", inst->body[j]);
         }
         fprintf(dimacs,"0\n");
     }
     return 0;
 }
+
+/*-----------------------------------------------------------------------------*/
+/*  binary instance output, with the occurrence index                          */
+/*-----------------------------------------------------------------------------*/
+#define BIN_ALIGN 64
+static uint64_t bin_section (uint64_t* top, uint64_t size) {
+    uint64_t at = (*top + BIN_ALIGN-1) & ~(uint64_t)(BIN_ALIGN-1);
+    *top = at + size;
+    return at;
+}
+static int bin_put (FILE* out, uint64_t* pos, uint64_t at, const void* data, size_t size) {
+    static const char pad[BIN_ALIGN];
+    for (; *pos < at; (*pos)++) if (fwrite (pad, 1, 1, out) != 1) return 0;
+    *pos += size;
+    return fwrite (data, 1, size, out) == size;
+}
+int inst_write_bin (inst_t* inst, FILE* out) {
+    inst_bin_t h;
+    int *occ_ix = inst->occ_ix, *occ = inst->occ, *ix_mem = NULL, n = inst->vars_no, ok;
+    uint64_t top = sizeof(inst_bin_t), pos = 0;
+
+    if (!occ_ix) {
+        ix_mem = calloc (2*n+2, sizeof(int));
+        occ = malloc ((inst->lits_no ? inst->lits_no : 1) * sizeof(int));
+        if (!ix_mem || !occ) { free (ix_mem); free (occ); return ERR_ALLOC; }
+        occ_ix = ix_mem + n;
+        inst_occ_fill (inst, occ_ix, occ);
+    }
+    memset (&h, 0, sizeof(h));
+    memcpy (h.magic, INST_BIN_MAGIC, sizeof(INST_BIN_MAGIC));
+    h.version = INST_BIN_VERSION;
+    h.order   = INST_BIN_ORDER;
+    h.vars_no = n;
+    h.length  = inst->length;
+    h.width   = inst->width;
+    h.lits_no = inst->lits_no;
+    h.body    = bin_section (&top, (uint64_t)inst->lits_no*sizeof(int32_t));
+    h.start   = bin_section (&top, ((uint64_t)inst->length+1)*sizeof(int32_t));
+    h.occ_ix  = bin_section (&top, (2*(uint64_t)n+2)*sizeof(int32_t));
+    h.occ     = bin_section (&top, (uint64_t)inst->lits_no*sizeof(int32_t));
+    ok = bin_put (out, &pos, 0, &h, sizeof(h))
+      && bin_put (out, &pos, h.body, inst->body, inst->lits_no*sizeof(int32_t))
+      && bin_put (out, &pos, h.start, inst->start, (inst->length+1)*sizeof(int32_t))
+      && bin_put (out, &pos, h.occ_ix, occ_ix-n, (2*n+2)*sizeof(int32_t))
+      && bin_put (out, &pos, h.occ, occ, inst->lits_no*sizeof(int32_t));
+    if (ix_mem) { free (ix_mem); free (occ); }
+    return ok ? 0 : ERR_FORMAT;
+}
@@ -2,27 +2,57 @@
 #define SAT_INST_H
 
 #include <stdio.h>
+#include <stdint.h>
 
 #define ERR_PROBLEM -1
 #define ERR_FORMAT  -2
 #define ERR_WIDTH   -3
 #define ERR_ALLOC -4
+#define ERR_BINARY -5
 
 typedef int literal_t;
 
+/* clause i is body[start[i]] .. body[start[i+1]-1], no padding */
 typedef struct  {
     int vars_no;
     int length;
-    int width;
+    int width;          /* the longest clause */
+    int lits_no;        /* literals in all clauses, start[length] */
     literal_t* body;
+    int* start;
+    int shared;         /* body and start owned elsewhere, inst_forget leaves them */
+    int* occ_ix;        /* occurrence index as in var_info, when it came with */
+    int* occ;           /* the instance (binary input), else NULL */
+    void* map;          /* binary input all this lives in, released by inst_forget */
+    size_t map_size;    /* 0 when map is a plain allocation */
 } inst_t;
 
-literal_t* inst_reserve (int clause_no, int clause_w);
+literal_t* inst_reserve (int lits_no);
 void inst_forget (inst_t* inst);
-int inst_width (inst_t* inst, FILE* dimacs);
-int inst_read (inst_t* inst, FILE* dimacs, int clause_w);
+int inst_read (inst_t* inst, FILE* dimacs, int clause_w);  /* clause_w 0: no limit, DIMACS or binary */
 void inst_read_fail (int err, const char* prog);
 int inst_write (inst_t* inst, FILE* dimacs);
+void inst_occ_fill (inst_t* inst, int* occ_ix, int* occ);  /* occ_ix zeroed, from -vars_no */
+
+/* --- binary instance: the header, then the sections at 64 byte aligned offsets */
+/* --- body, start, occ_ix (from literal -vars_no) and occ, as in memory */
+#define INST_BIN_MAGIC   "GSATCNF"
+#define INST_BIN_VERSION 1
+#define INST_BIN_ORDER   0x01020304u
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t order;     /* byte order check */
+    int32_t  vars_no;
+    int32_t  length;
+    int32_t  width;
+    int32_t  lits_no;
+    uint64_t body;      /* section offsets in bytes */
+    uint64_t start;
+    uint64_t occ_ix;
+    uint64_t occ;
+} inst_bin_t;
+int inst_write_bin (inst_t* inst, FILE* out);
 
 
 #endif
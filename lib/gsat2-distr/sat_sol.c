@@ -4,16 +4,30 @@
 #include "sat_sol.h"
 #include "xoshiro256plus.h"
 
-/* --- structure: -xn | ... | -x1 | 0 | x1 | ... | xn | ------- */
+/* --- structure: -xn | ... | -x1 | 0 | x1 | ... | xn | pad --- */
+/* --- the pad lets a vector gather read 4 bytes at any literal */
+#define SOL_PAD 3
 sol_t sol_reserve (int vars) {
     int v;
     sol_t sol;
-    sol=calloc (2*vars+1, sizeof(bool_val));
+    sol=calloc (2*vars+1+SOL_PAD, sizeof(bool_val));
+    if (!sol) return NULL;
     sol += vars;  /* so that sol[0] is the (nonexistent) x0, sol[i] is xi, sol[-i] is not xi */
     for(v=1; v <= vars; v++) sol_set(sol, v, 0); 
     return sol;		
 }
 
+size_t sol_size (int vars) {
+    return (2*vars+1+SOL_PAD) * sizeof(bool_val);
+}
+
+sol_t sol_place (void* space, int vars) {
+    int v;
+    sol_t sol = (sol_t)space + vars;
+    for(v=1; v <= vars; v++) sol_set(sol, v, 0); 
+    return sol;
+}
+
 void sol_copy (sol_t from, sol_t to, int vars) {
     memcpy (to-vars, from-vars, (2*vars+1) * sizeof(bool_val));
 }
@@ -35,11 +49,15 @@ int sol_flip (sol_t sol, int ix) {
     sol[-ix]=sol[ix]? 0 : 1;
     return 0;
 }
-int sol_rand (sol_t sol, int vars) {
+int sol_rand_r (rng_state_t* ps, sol_t sol, int vars) {
+    rng_bits_t bits = RNG_BITS_INIT;
     int j;
-    for (j=1; j<=vars; j++) sol_set (sol, j, rng_next_range (0,1));
+    for (j=1; j<=vars; j++) sol_set (sol, j, rng_next_bit_r (ps, &bits));
     return 0;
 }
+int sol_rand (sol_t sol, int vars) {
+    return sol_rand_r (rng_global(), sol, vars);
+}
 
 int sol_write (sol_t sol, FILE* out, int vars) {
     int j;
@@ -72,6 +90,84 @@ int sol_read_str (sol_t sol, const char* in, int vars) {
     return 1;
 }
 
+/* --------------------------------------------------------------- */
+/* --- packed solutions: the bulk operations run a word at a time, */
+/* --- 64 variables in one xor and one popcount; the popcount ----- */
+/* --- instruction is used when the CPU has it, a call otherwise -- */
+#if defined(__GNUC__)
+#define bsol_popcount(x) __builtin_popcountll (x)
+#else
+static int bsol_popcount (bsol_word x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+#endif
+#define BSOL_ONES(word) { int i, c = 0; for (i=0; i<words; i++) c += bsol_popcount (word); return c; }
+static int bsol_ones (bsol_t a, int words) BSOL_ONES(a[i])
+static int bsol_ones_xor (bsol_t a, bsol_t b, int words) BSOL_ONES(a[i] ^ b[i])
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+__attribute__((target("popcnt"))) static int bsol_ones_popcnt (bsol_t a, int words) BSOL_ONES(a[i])
+__attribute__((target("popcnt"))) static int bsol_ones_xor_popcnt (bsol_t a, bsol_t b, int words) BSOL_ONES(a[i] ^ b[i])
+#define BSOL_POPCNT __builtin_cpu_supports ("popcnt")
+#else
+#define bsol_ones_popcnt bsol_ones
+#define bsol_ones_xor_popcnt bsol_ones_xor
+#define BSOL_POPCNT 0
+#endif
+
+bsol_t bsol_reserve (int vars) {
+    return calloc (BSOL_WORDS(vars), sizeof(bsol_word));
+}
+bsol_t bsol_forget (bsol_t b) {
+    if (b) free (b);
+    return NULL;
+}
+int bsol_set (bsol_t b, int ix, int val) {
+    if (BSOL_VAL(b, ix) != !!val) BSOL_FLIP(b, ix);
+    return 0;
+}
+void bsol_copy (bsol_t from, bsol_t to, int vars) {
+    memcpy (to, from, BSOL_WORDS(vars) * sizeof(bsol_word));
+}
+int bsol_cmp (bsol_t a, bsol_t b, int vars) {
+    return memcmp (a, b, BSOL_WORDS(vars) * sizeof(bsol_word));
+}
+int bsol_distance (bsol_t a, bsol_t b, int vars) {
+    return BSOL_POPCNT ? bsol_ones_xor_popcnt (a, b, BSOL_WORDS(vars)) : bsol_ones_xor (a, b, BSOL_WORDS(vars));
+}
+int bsol_count (bsol_t b, int vars) {
+    return BSOL_POPCNT ? bsol_ones_popcnt (b, BSOL_WORDS(vars)) : bsol_ones (b, BSOL_WORDS(vars));
+}
+void bsol_pack (sol_t sol, bsol_t b, int vars) {
+    int v;
+    memset (b, 0, BSOL_WORDS(vars) * sizeof(bsol_word));
+    for (v=1; v<=vars; v++) b[v >> 6] |= (bsol_word)(sol[v] != 0) << (v & 63);
+}
+void bsol_unpack (bsol_t b, sol_t sol, int vars) {
+    int v;
+    for (v=1; v<=vars; v++) sol_set (sol, v, BSOL_VAL(b, v));
+}
+int bsol_rand_r (rng_state_t* ps, sol_t sol, bsol_t b, int vars) {
+    rng_bits_t bits = RNG_BITS_INIT;
+    bsol_word word = 0;
+    int j, bit;
+    for (j=1; j<=vars; j++) {                                   /* the same draws as sol_rand_r */
+        bit = rng_next_bit_r (ps, &bits);
+        sol_set (sol, j, bit);
+        word |= (bsol_word)bit << (j & 63);
+        if ((j & 63) == 63) { b[j >> 6] = word; word = 0; }
+    }
+    if ((vars & 63) != 63) b[vars >> 6] = word;                  /* the last word, partly used */
+    return 0;
+}
+int bsol_write (bsol_t b, FILE* out, int vars) {
+    int j;
+    for (j=1; j<=vars; j++) fprintf(out, "%d ", BSOL_VAL(b, j)? j : -j);
+    fprintf(out,"0\n");
+    return 0;
+}
 
 /* --------------------------------------------------------------- */
 cnt_t cnt_reserve (int length) {
@@ -81,4 +177,21 @@ cnt_t cnt_forget (cnt_t cnt) {
     if (cnt) free (cnt);
     return NULL;
 }
-
+/* --------------------------------------------------------------- */
+false_list_t false_reserve (int length) {
+    false_list_t fals;
+    fals = calloc (1, sizeof(false_list));
+    if (!fals) return NULL;
+    fals->clause = calloc (length, sizeof(clause_ix_t));
+    fals->where = calloc (length, sizeof(int));
+    if (!fals->clause || !fals->where) return false_forget (fals);
+    return fals;
+}
+false_list_t false_forget (false_list_t fals) {
+    if (fals) {
+        free (fals->clause);
+        free (fals->where);
+        free (fals);
+    }
+    return NULL;
+}
@@ -1,6 +1,7 @@
 #ifndef SAT_SOL_H
 #define SAT_SOL_H
 #include <stdio.h>
+#include <stdint.h>
 #include "rngctrl.h"
 
 typedef unsigned char bool_val;
@@ -8,32 +9,75 @@ typedef bool_val* sol_t;
 
 sol_t sol_reserve (int vars);
 sol_t sol_forget (sol_t sol, int vars);
+size_t sol_size (int vars);                     /* the same in caller's space */
+sol_t sol_place (void* space, int vars);
 
 /* --- variable indices from 1 ---------- */
 int sol_set (sol_t sol, int ix, bool_val val);
 int sol_flip (sol_t sol, int ix);
 int sol_rand (sol_t sol, int vars);
+int sol_rand_r (rng_state_t* ps, sol_t sol, int vars);
 void sol_copy (sol_t from, sol_t to, int vars);
 
 int sol_write (sol_t sol, FILE* out, int vars);
 int sol_read (sol_t sol, FILE* in, int vars);
 int sol_read_str (sol_t sol, const char* in, int vars);
 
+/* --- packed: a bit per variable, xi is bit i%64 of word i/64 ------- */
+/* --- a literal is true when the bit of its variable differs from ---- */
+/* --- its sign bit; the bits of x0 and past xn stay 0, so that ------ */
+/* --- whole words compare; n/64+1 words instead of 2n+1 bytes ------- */
+typedef uint64_t bsol_word;
+typedef bsol_word* bsol_t;
+#define BSOL_WORDS(vars)    ((vars)/64 + 1)
+#define BSOL_VAL(b,ix)      ((int)((b)[(ix) >> 6] >> ((ix) & 63)) & 1)
+#define BSOL_LIT(b,lit)     (BSOL_VAL(b, (lit) > 0 ? (lit) : -(lit)) ^ ((lit) < 0))
+#define BSOL_FLIP(b,ix)     ((b)[(ix) >> 6] ^= (bsol_word)1 << ((ix) & 63))
+
+bsol_t bsol_reserve (int vars);
+bsol_t bsol_forget (bsol_t b);
+int bsol_set (bsol_t b, int ix, int val);
+void bsol_copy (bsol_t from, bsol_t to, int vars);
+int bsol_cmp (bsol_t a, bsol_t b, int vars);        /* 0 when the same */
+int bsol_distance (bsol_t a, bsol_t b, int vars);   /* variables of different values */
+int bsol_count (bsol_t b, int vars);                /* variables true */
+void bsol_pack (sol_t sol, bsol_t b, int vars);
+void bsol_unpack (bsol_t b, sol_t sol, int vars);
+int bsol_rand_r (rng_state_t* ps, sol_t sol, bsol_t b, int vars);   /* sol_rand_r and bsol_pack */
+int bsol_write (bsol_t b, FILE* out, int vars);
+
 /* --- aux true literals count --------- */
 typedef unsigned int cnt_val;
 typedef cnt_val* cnt_t;
 cnt_t cnt_reserve (int length);
 cnt_t cnt_forget (cnt_t cnt);
+typedef uint8_t cnt8_val;                           /* the same in a byte, for clauses */
+typedef cnt8_val* cnt8_t;                           /* of at most CNT8_MAX literals */
+#define CNT8_MAX 255
 
 /* --- aux inverted instance ----------- */
+/* clauses where literal l occurs are occ[occ_ix[l]] .. occ[occ_ix[l+1]-1] */
 typedef int clause_ix_t;
+typedef uint16_t clause_ix16_t;                     /* for at most CLAUSE_IX16_MAX+1 clauses */
+#define CLAUSE_IX16_MAX 65535
 typedef struct {
-    int pos_occ_no;
-    int neg_occ_no;
-    clause_ix_t* pos_occ;
-    clause_ix_t* neg_occ;
+    int vars_no;
+    int* occ_ix;            /* from -vars_no to vars_no+1, like the solution */
+    clause_ix_t* occ;
+    clause_ix16_t* occ16;   /* occ again in 16 bits, when the instance fits, else NULL */
+    void* arena;            /* the allocation all this lives in */
 } var_info;
 typedef var_info* var_info_t;
 
+/* --- aux list of false clauses ------ */
+typedef struct {
+    int no;                 /* number of false clauses */
+    clause_ix_t* clause;    /* the false clauses, in no particular order */
+    int* where;             /* where[i] is the position of clause i in the list */
+} false_list;
+typedef false_list* false_list_t;
+false_list_t false_reserve (int length);
+false_list_t false_forget (false_list_t fals);
+
 #endif
 
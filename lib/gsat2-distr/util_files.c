@@ -6,7 +6,7 @@ int util_file_in (file_t* f) {
         if (strcmp (f->name, "-") == 0) {        
             f->file = stdin;
         } else {    
-            f->file = fopen (f->name, "r");
+            f->file = fopen (f->name, "rb");      /* the instance may be binary */
             if (!f->file) { perror(f->name); return 0; }
         }
     }
@@ -23,6 +23,17 @@ int util_file_out (file_t* f) {
     }
     return 1;
 }
+int util_file_bin (file_t* f) {
+    if (f->name) {
+        if (strcmp (f->name, "-") == 0) {        
+            f->file = stdout;
+        } else {    
+            f->file = fopen (f->name, "wb");
+            if (!f->file) { perror(f->name); return 0; }
+        }
+    }
+    return 1;
+}
 int util_file_log (file_t* f) {
     if (f->name) {
         if (strcmp (f->name, "-") == 0) {        
@@ -9,6 +9,7 @@ typedef struct {
 
 int util_file_in (file_t*);
 int util_file_out (file_t*);
+int util_file_bin (file_t*);
 int util_file_log (file_t*);
 int util_file_close (file_t*);
 #endif
@@ -15,6 +15,7 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 #endif
 #include <inttypes.h>
 #include <math.h>
+#include <string.h>
 #include "xoshiro256plus.h"
 
 /* This is xoshiro256+ 1.0, our best and fastest generator for floating-point
@@ -45,37 +46,41 @@ static rng_state_t state = {
       0X740D405A8D1938C8 } 
 };
 
+rng_state_t* rng_global (void) {
+	return &state;
+}
+
+void rng_set_state_uint_r (rng_state_t* ps, uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3) {
+	ps->s[0] = s0;
+	ps->s[1] = s1;
+	ps->s[2] = s2;
+	ps->s[3] = s3;
+}
 void rng_set_state_uint (uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3) {
-	state.s[0] = s0;
-	state.s[1] = s1;
-	state.s[2] = s2;
-	state.s[3] = s3;
+	rng_set_state_uint_r (&state, s0, s1, s2, s3);
 }
 
 void rng_set_state (rng_state_t* pstate) {
-	state.s[0] = pstate->s[0];
-	state.s[1] = pstate->s[1];
-	state.s[2] = pstate->s[2];
-	state.s[3] = pstate->s[3];
+	state = *pstate;
 }
 
 void rng_get_state (rng_state_t* pstate) {
-	pstate->s[0] = state.s[0];
-	pstate->s[1] = state.s[1];
-	pstate->s[2] = state.s[2];
-	pstate->s[3] = state.s[3];
+	*pstate = state;
 } 
 
-void rng_set_seed(uint64_t seed) {
-    /* seeding the aux generator */
-    splitmix64_set_seed (seed);
+void rng_set_seed_r (rng_state_t* ps, uint64_t seed) {
+    /* seeding an aux generator of our own */
+    uint64_t x = seed;
 
-    /* setting the main generator */
-    rng_set_state_uint (
-	splitmix64_next(), 
-	splitmix64_next(), 
-	splitmix64_next(), 
-	splitmix64_next());
+    /* setting the main generator, last word first, as the seeds of */
+    /* gsat2 have always been, whatever the compiler */
+    ps->s[3] = splitmix64_next_r (&x);
+    ps->s[2] = splitmix64_next_r (&x);
+    ps->s[1] = splitmix64_next_r (&x);
+    ps->s[0] = splitmix64_next_r (&x);
+}
+void rng_set_seed(uint64_t seed) {
+    rng_set_seed_r (&state, seed);
 }
 
 #define P64 "%#018" PRIX64
@@ -107,50 +112,56 @@ int  rng_state_read   (FILE* in,  rng_state_t* pstate) {
 } 
 
 
-uint64_t rng_next(void) {
-	const uint64_t result_plus = state.s[0] + state.s[3];
+uint64_t rng_next_r(rng_state_t* ps) {
+	const uint64_t result_plus = ps->s[0] + ps->s[3];
 
-	const uint64_t t = state.s[1] << 17;
+	const uint64_t t = ps->s[1] << 17;
 
-	state.s[2] ^= state.s[0];
-	state.s[3] ^= state.s[1];
-	state.s[1] ^= state.s[2];
-	state.s[0] ^= state.s[3];
+	ps->s[2] ^= ps->s[0];
+	ps->s[3] ^= ps->s[1];
+	ps->s[1] ^= ps->s[2];
+	ps->s[0] ^= ps->s[3];
 
-	state.s[2] ^= t;
+	ps->s[2] ^= t;
 
-	state.s[3] = rotl(state.s[3], 45);
+	ps->s[3] = rotl(ps->s[3], 45);
 
 	return result_plus;
 }
+uint64_t rng_next(void) {
+	return rng_next_r (&state);
+}
 
 
 /* This is the jump function for the generator. It is equivalent
    to 2^128 calls to rng_next(); it can be used to generate 2^128
    non-overlapping subsequences for parallel computations. */
 
-void rng_jump(void) {
+void rng_jump_r(rng_state_t* ps) {
 	static const uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
 
 	uint64_t s0 = 0;
 	uint64_t s1 = 0;
 	uint64_t s2 = 0;
 	uint64_t s3 = 0;
-	for(int i = 0; i < sizeof JUMP / sizeof *JUMP; i++)
+	for(int i = 0; i < (int)(sizeof JUMP / sizeof *JUMP); i++)
 		for(int b = 0; b < 64; b++) {
 			if (JUMP[i] & UINT64_C(1) << b) {
-				s0 ^= state.s[0];
-				s1 ^= state.s[1];
-				s2 ^= state.s[2];
-				s3 ^= state.s[3];
+				s0 ^= ps->s[0];
+				s1 ^= ps->s[1];
+				s2 ^= ps->s[2];
+				s3 ^= ps->s[3];
 			}
-			rng_next();	
+			rng_next_r(ps);	
 		}
 		
-	state.s[0] = s0;
-	state.s[1] = s1;
-	state.s[2] = s2;
-	state.s[3] = s3;
+	ps->s[0] = s0;
+	ps->s[1] = s1;
+	ps->s[2] = s2;
+	ps->s[3] = s3;
+}
+void rng_jump(void) {
+	rng_jump_r (&state);
 }
 
 
@@ -159,28 +170,31 @@ void rng_jump(void) {
    from each of which jump() will generate 2^64 non-overlapping
    subsequences for parallel distributed computations. */
 
-void rng_long_jump(void) {
+void rng_long_jump_r(rng_state_t* ps) {
 	static const uint64_t LONG_JUMP[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
 
 	uint64_t s0 = 0;
 	uint64_t s1 = 0;
 	uint64_t s2 = 0;
 	uint64_t s3 = 0;
-	for(int i = 0; i < sizeof LONG_JUMP / sizeof *LONG_JUMP; i++)
+	for(int i = 0; i < (int)(sizeof LONG_JUMP / sizeof *LONG_JUMP); i++)
 		for(int b = 0; b < 64; b++) {
 			if (LONG_JUMP[i] & UINT64_C(1) << b) {
-				s0 ^= state.s[0];
-				s1 ^= state.s[1];
-				s2 ^= state.s[2];
-				s3 ^= state.s[3];
+				s0 ^= ps->s[0];
+				s1 ^= ps->s[1];
+				s2 ^= ps->s[2];
+				s3 ^= ps->s[3];
 			}
-			rng_next();	
+			rng_next_r(ps);	
 		}
 		
-	state.s[0] = s0;
-	state.s[1] = s1;
-	state.s[2] = s2;
-	state.s[3] = s3;
+	ps->s[0] = s0;
+	ps->s[1] = s1;
+	ps->s[2] = s2;
+	ps->s[3] = s3;
+}
+void rng_long_jump(void) {
+	rng_long_jump_r (&state);
 }
 
 /* This is a fixed-increment version of Java 8's SplittableRandom generator
@@ -195,12 +209,15 @@ void rng_long_jump(void) {
 
 static uint64_t x; /* The state can be seeded with any value. */
 
-uint64_t splitmix64_next() {
-	uint64_t z = (x += 0x9e3779b97f4a7c15);
+uint64_t splitmix64_next_r(uint64_t* px) {
+	uint64_t z = (*px += 0x9e3779b97f4a7c15);
 	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
 	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
 	return z ^ (z >> 31);
 }
+uint64_t splitmix64_next() {
+	return splitmix64_next_r (&x);
+}
 void splitmix64_set_seed (uint64_t seed) {
 	x = seed;
 }
@@ -219,13 +236,16 @@ int  rng_seed_write  (FILE* out,    rng_seed_t* pseed) {
     return 1;
 }
 
-double rng_next_double () {
-    uint64_t r = rng_next();
+double rng_next_double_r (rng_state_t* ps) {
+    uint64_t r = rng_next_r(ps);
     double   h = (r >> 38) << 27;   /* uppermost 26 bits, shifted */
     double   l = (r << 26) >> 37;   /* the following 27 bits */
 /*  return (((long)next(26) << 27) + next(27)) / (double)(1LL << 53); */
     return (h + l) / (double)(1LL << 53);
 }
+double rng_next_double () {
+    return rng_next_double_r (&state);
+}
 /*-----------------------------------------------------------------------------
 	transformation from (0,1) to (low .. high) inclusive
 -----------------------------------------------------------------------------*/
@@ -237,18 +257,173 @@ double rng_to_range_dbl (double low, double high, double val) {
     return val * (high-low) + low;
 }
 
+/*-----------------------------------------------------------------------------
+	bounded integers by multiply-shift (D. Lemire, Fast Random Integer 
+	Generation in an Interval, ACM TOMACS 29(1), 2019); the upper 32 bits
+	of a draw are scaled, the rare biased low products are redrawn, so 
+	there is a division only when a redraw is possible at all
+-----------------------------------------------------------------------------*/
+uint32_t rng_next_below_r (rng_state_t* ps, uint32_t n) {
+    uint64_t m = (rng_next_r(ps) >> 32) * (uint64_t)n;
+    uint32_t l = (uint32_t)m;
+    if (l < n) {
+        uint32_t t = -n % n;                        /* 2^32 mod n */
+        while (l < t) {
+            m = (rng_next_r(ps) >> 32) * (uint64_t)n;
+            l = (uint32_t)m;
+        }
+    }
+    return m >> 32;
+}
+uint32_t rng_next_below (uint32_t n) {
+    return rng_next_below_r (&state, n);
+}
+/*-----------------------------------------------------------------------------
+	the whole 64-bit draw scaled by n, the upper half of the 96-bit product
+	in two 32x32 multiplies; where rng_next_below_r would redraw nearly 
+	every time (n close to 2^32), a bias of n/2^64 costs nothing
+-----------------------------------------------------------------------------*/
+uint32_t rng_next_scale_r (rng_state_t* ps, uint32_t n) {
+    uint64_t x = rng_next_r(ps);
+    return ((x >> 32) * n + (((x & 0xFFFFFFFFu) * n) >> 32)) >> 32;
+}
+
+unsigned rng_next_range_r (rng_state_t* ps, unsigned low, unsigned high) {
+    unsigned span = high-low+1;
+    if (span == 0) return low + (unsigned)(rng_next_r(ps) >> 32);  /* the whole unsigned range */
+    return low + rng_next_below_r (ps, span);
+}
 unsigned rng_next_range (unsigned low, unsigned high) {
-    return round (rng_next_double() * (high-low+1) - 0.5 + low);
+    return rng_next_range_r (&state, low, high);
 }
 
+double rng_next_range_dbl_r (rng_state_t* ps, double low, double high) {
+    return rng_next_double_r(ps) * (high-low) + low;
+}
 double rng_next_range_dbl (double low, double high) {
-    return rng_next_double() * (high-low) + low;
+    return rng_next_range_dbl_r (&state, low, high);
+}
+/*-----------------------------------------------------------------------------
+	a Bernoulli trial without floating point: the threshold is the 
+	probability scaled to the 53 bits rng_next_double uses, so that
+	rng_next_prob_r(ps,rng_prob_thr(p)) == (rng_next_double_r(ps) <= p) 
+-----------------------------------------------------------------------------*/
+uint64_t rng_prob_thr (double p) {
+    if (p <= 0.0) return 0;
+    if (p >= 1.0) return UINT64_C(1) << 53;
+    return (uint64_t)(p * (double)(UINT64_C(1) << 53));
+}
+int rng_next_prob_r (rng_state_t* ps, uint64_t thr) {
+    return (rng_next_r(ps) >> 11) <= thr;
+}
+int rng_next_prob (uint64_t thr) {
+    return rng_next_prob_r (&state, thr);
+}
+/*-----------------------------------------------------------------------------
+	single random bits, 64 of them per draw, taken from the top down
+	(sign test, the upper bits of xoshiro256+ are the good ones)
+-----------------------------------------------------------------------------*/
+int rng_next_bit_r (rng_state_t* ps, rng_bits_t* pb) {
+    int bit;
+    if (pb->left == 0) {
+        pb->word = rng_next_r(ps);
+        pb->left = 64;
+    }
+    bit = pb->word >> 63;
+    pb->word <<= 1;
+    pb->left--;
+    return bit;
+}
+int rng_next_bit (rng_bits_t* pb) {
+    return rng_next_bit_r (&state, pb);
+}
+/*-----------------------------------------------------------------------------
+	bulk generation: rng_fill gives exactly what n calls of rng_next
+	would; the lanes run RNG_LANES generators side by side, kept word by
+	word in structure-of-arrays form so that one step is a handful of 
+	vector operations
+-----------------------------------------------------------------------------*/
+void rng_fill_r (rng_state_t* ps, uint64_t* buf, size_t n) {
+    uint64_t s0 = ps->s[0], s1 = ps->s[1], s2 = ps->s[2], s3 = ps->s[3], t;
+    size_t i;
+    for (i=0; i<n; i++) {                           /* rng_next_r with the state in registers */
+        buf[i] = s0 + s3;
+        t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 45);
+    }
+    ps->s[0] = s0; ps->s[1] = s1; ps->s[2] = s2; ps->s[3] = s3;
+}
+void rng_fill (uint64_t* buf, size_t n) {
+    rng_fill_r (&state, buf, n);
+}
+
+void rng_lanes_seed_r (rng_lanes_t* pl, rng_state_t* ps) {
+    int i, k;
+    for (i=0; i<RNG_LANES; i++) {
+        for (k=0; k<4; k++) pl->s[k][i] = ps->s[k];
+        rng_jump_r (ps);
+    }
+}
+void rng_lanes_seed (rng_lanes_t* pl) {
+    rng_lanes_seed_r (pl, &state);
+}
+
+#if defined(__GNUC__) && RNG_LANES == 4
+/* generic vectors: SSE2 pairs, AVX2 or wider when the target has them */
+typedef uint64_t rng_vec_t __attribute__ ((vector_size (4*sizeof(uint64_t))));
+
+static inline void lanes_step (rng_lanes_t* pl, uint64_t* out) {
+    rng_vec_t s0, s1, s2, s3, t;
+    memcpy (&s0, pl->s[0], sizeof s0); memcpy (&s1, pl->s[1], sizeof s1);
+    memcpy (&s2, pl->s[2], sizeof s2); memcpy (&s3, pl->s[3], sizeof s3);
+    t = s0 + s3;
+    memcpy (out, &t, sizeof t);
+    t = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = (s3 << 45) | (s3 >> 19);
+    memcpy (pl->s[0], &s0, sizeof s0); memcpy (pl->s[1], &s1, sizeof s1);
+    memcpy (pl->s[2], &s2, sizeof s2); memcpy (pl->s[3], &s3, sizeof s3);
+}
+#else
+static inline void lanes_step (rng_lanes_t* pl, uint64_t* out) {
+    uint64_t t;
+    int i;
+    for (i=0; i<RNG_LANES; i++) {
+        out[i] = pl->s[0][i] + pl->s[3][i];
+        t = pl->s[1][i] << 17;
+        pl->s[2][i] ^= pl->s[0][i];
+        pl->s[3][i] ^= pl->s[1][i];
+        pl->s[1][i] ^= pl->s[2][i];
+        pl->s[0][i] ^= pl->s[3][i];
+        pl->s[2][i] ^= t;
+        pl->s[3][i] = rotl(pl->s[3][i], 45);
+    }
+}
+#endif
+
+void rng_lanes_fill (rng_lanes_t* pl, uint64_t* buf, size_t n) {
+    uint64_t tail[RNG_LANES];
+    size_t i;
+    for (i=0; i+RNG_LANES <= n; i+=RNG_LANES) lanes_step (pl, buf+i);
+    if (i < n) {                                    /* the rest of the last step is dropped */
+        lanes_step (pl, tail);
+        memcpy (buf+i, tail, (n-i)*sizeof(uint64_t));
+    }
 }
 /*---------------------------------------------------------------------------*/
 /* Fisher-Yates shuffle, aka Knuth shuffle 				     */
 /*---------------------------------------------------------------------------*/
-static inline unsigned uniform(unsigned m) { /* Returns a random integer 0 <= uniform(m) <= m-1 with uniform distribution */
-    return rng_next_range (0, m-1);
+static inline unsigned uniform(rng_state_t* ps, unsigned m) { /* Returns a random integer 0 <= uniform(m) <= m-1 with uniform distribution */
+    return rng_next_range_r (ps, 0, m-1);
 }
 /*---------------------------------------------------------------------------*/
 static inline void swap (unsigned* pa, unsigned* pb) {
@@ -256,24 +431,31 @@ static inline void swap (unsigned* pa, unsigned* pb) {
     *pa = *pb;
     *pb = x;
 }
-void rng_permute(unsigned permutation[], unsigned n)
+void rng_permute_r(rng_state_t* ps, unsigned permutation[], unsigned n)
 {
     unsigned i, j;
     if (n<2) return;
     for (i = 0; i <= n-2; i++) {
-        j = i+uniform(n-i); /* A random integer such that i ? j < n*/
+        j = i+uniform(ps, n-i); /* A random integer such that i ? j < n*/
         swap(&permutation[i], &permutation[j]);   /* Swap the randomly picked element with permutation[i] */
     }
 }
+void rng_permute(unsigned permutation[], unsigned n)
+{
+    rng_permute_r (&state, permutation, n);
+}
 /*---------------------------------------------------------------------------*/
 /* random numbers (0,1) in a given distribution                              */
 /* the density function is from (0,1) to (0,1)                               */
 /*---------------------------------------------------------------------------*/
-double rng_next_dist (rng_density dfunc, void* par) {
+double rng_next_dist_r (rng_state_t* ps, rng_density dfunc, void* par) {
     double cand, thr;
     do {
-       cand = rng_next_double();
+       cand = rng_next_double_r(ps);
        thr = (*dfunc)(cand, par);
-    } while (rng_next_double() > thr);
+    } while (rng_next_double_r(ps) > thr);
     return cand;
 }
+double rng_next_dist (rng_density dfunc, void* par) {
+    return rng_next_dist_r (&state, dfunc, par);
+}
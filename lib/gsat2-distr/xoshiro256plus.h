@@ -13,6 +13,7 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stddef.h>
 
 /* State structure, permitting to save and restore RNG state */
 
@@ -37,14 +38,18 @@ typedef uint64_t rng_seed_t;
    a 64-bit seed, we suggest to seed a splitmix64 generator and use its
    output to fill s. */
 
+/* Every function comes in two flavours: the _r one works on the state
+   given, the plain one on a single global state (see rng_global). */
 
 uint64_t rng_next(void);
+uint64_t rng_next_r(rng_state_t* ps);
 
 /* This is the jump function for the generator. It is equivalent
    to 2^128 calls to next(); it can be used to generate 2^128
    non-overlapping subsequences for parallel computations. */
 
 void rng_jump(void);
+void rng_jump_r(rng_state_t* ps);
 /* This is the long-jump function for the generator. It is equivalent to
    2^192 calls to next(); it can be used to generate 2^64 starting points,
    from each of which jump() will generate 2^64 non-overlapping
@@ -52,19 +57,63 @@ void rng_jump(void);
 
 
 void rng_long_jump(void);
+void rng_long_jump_r(rng_state_t* ps);
 
 double   rng_next_double ();
+double   rng_next_double_r (rng_state_t* ps);
 unsigned rng_to_range (unsigned low, unsigned high, double val);
 unsigned rng_next_range (unsigned low, unsigned high);
+unsigned rng_next_range_r (rng_state_t* ps, unsigned low, unsigned high);
 double   rng_to_range_dbl (double low, double high, double val);
 double   rng_next_range_dbl (double low, double high);
+double   rng_next_range_dbl_r (rng_state_t* ps, double low, double high);
 void     rng_permute(unsigned permutation[], unsigned n);
+void     rng_permute_r(rng_state_t* ps, unsigned permutation[], unsigned n);
+
+/* bounded integers 0 .. n-1 without floating point and without bias */
+uint32_t rng_next_below (uint32_t n);
+uint32_t rng_next_below_r (rng_state_t* ps, uint32_t n);
+/* the same with a bias below n/2^64 instead, never redrawn: for n near 2^32 */
+uint32_t rng_next_scale_r (rng_state_t* ps, uint32_t n);
+
+/* 1 with probability p, the threshold computed once by rng_prob_thr(p) */
+uint64_t rng_prob_thr (double p);
+int      rng_next_prob (uint64_t thr);
+int      rng_next_prob_r (rng_state_t* ps, uint64_t thr);
+
+/* single random bits, one draw serves 64 calls; start from RNG_BITS_INIT */
+typedef struct {
+    uint64_t word;
+    int      left;
+} rng_bits_t;
+#define RNG_BITS_INIT {0, 0}
+int      rng_next_bit (rng_bits_t* pb);
+int      rng_next_bit_r (rng_state_t* ps, rng_bits_t* pb);
+
+/* bulk generation, n draws to buf */
+void     rng_fill (uint64_t* buf, size_t n);
+void     rng_fill_r (rng_state_t* ps, uint64_t* buf, size_t n);
+
+/* RNG_LANES independent generators stepped together, s[k][i] is the k-th
+   state word of lane i; lane i starts from the given state jumped i times 
+   and the given state is left jumped RNG_LANES times. The lanes fill
+   buf lane by lane, step after step; a step not used up is lost. */
+#define RNG_LANES 4
+typedef struct {
+    uint64_t s[4][RNG_LANES];
+} rng_lanes_t;
+void     rng_lanes_seed (rng_lanes_t* pl);
+void     rng_lanes_seed_r (rng_lanes_t* pl, rng_state_t* ps);
+void     rng_lanes_fill (rng_lanes_t* pl, uint64_t* buf, size_t n);
 
 typedef double (*rng_density)(double arg, void* par);
 double rng_next_dist (rng_density dfunc, void* par);
+double rng_next_dist_r (rng_state_t* ps, rng_density dfunc, void* par);
 
 /* state manipulation functions */
+rng_state_t* rng_global (void);         /* the state behind the plain functions */
 void rng_set_state_uint (uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3); 
+void rng_set_state_uint_r (rng_state_t* ps, uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3); 
 void rng_set_state (rng_state_t* pstate); 
 void rng_get_state (rng_state_t* pstate); 
 #define RNG_STATE_CHARS 76
@@ -75,6 +124,7 @@ int  rng_state_write  (FILE*, rng_state_t*);
 
 /* seed manipulation functions */
 void rng_set_seed(uint64_t seed); 
+void rng_set_seed_r(rng_state_t* ps, uint64_t seed); 
 #define RNG_SEED_CHARS 20
 int  rng_seed_deseri (char*, rng_seed_t*);
 int  rng_seed_seri   (char*, rng_seed_t*);
@@ -83,6 +133,7 @@ int  rng_seed_write  (FILE*, rng_seed_t*);
 
 /* the splitmix64 generator, mainly for seeding the main generator */
 uint64_t splitmix64_next();
+uint64_t splitmix64_next_r(uint64_t* px);
 void splitmix64_set_seed (uint64_t seed);
 
 #endif
@@ -17,98 +17,147 @@
 #include <float.h>
 #include <getopt.h>
 #include <signal.h>
+#include "../gsat2-distr/sat_inst.h" //binary instances
+#include "../gsat2-distr/xoshiro256plus.h"
+#include "../gsat2-distr/rngctrl.h"
+#include "probSAT.h"
 
-#define MAXCLAUSELENGTH 10000 //maximum number of literals per clause //TODO: eliminate this limit
-#define STOREBLOCK  20000
+#define CACHELINE 64 //alignment of the clause and occurrence arenas
+#define CM_TABLE_MAX (1 << 20) //most entries of the make x break table
+/** Clause c and its length; for clauses all of width w (w > 0) clause c is at lits[c*w]. With w
+ * a constant the functions taking it are width kernels, their loops over a clause unroll.*/
+#define CLAUSE(ps, c, w) ((w) ? (ps)->lits + (c) * (w) : (ps)->lits + (ps)->clauseStart[c])
+#define CLAUSELEN(ps, c, w) ((w) ? (w) : (ps)->clauseStart[(c) + 1] - (ps)->clauseStart[c])
 # undef LLONG_MAX
 #define LLONG_MAX  9223372036854775807
 #define BIGINT long long int
 
-void (*initLookUpTable)() = NULL;
-void (*pickAndFlipVar)() = NULL;
-
-/*--------*/
-
-/*----Instance data (independent from assignment)----*/
-/** The numbers of variables. */
-int numVars;
-/** The number of clauses. */
-int numClauses;
-/** The number of literals. */
-int numLiterals;
-/** The value of the variables. The numbering starts at 1 and the possible values are 0 or 1. */
-char *atom;
-/** The clauses of the formula represented as: clause[clause_number][literal_number].
- * The clause and literal numbering start both at 1. literal and clause 0 0 is sentinel*/
-int **clause;
-/**min and max clause length*/
-int maxClauseSize;
-int minClauseSize;
-/** The number of occurrence of each literal.*/
-int *numOccurrence;
-/** The clauses where each literal occurs. For literal i : occurrence[i+MAXATOMS][j] gives the clause =
- * the j'th occurrence of literal i.  */
-int **occurrence;
-int maxNumOccurences = 0; //maximum number of occurences for a literal
-/*--------*/
-
-/**----Assignment dependent data----*/
-/** The number of false clauses.*/
-int numFalse;
-/** Array containing all clauses that are false. Managed as a list.*/
-int *falseClause;
-/** whereFalse[i]=j tells that clause i is listed in falseClause at position j.  */
-int *whereFalse;
-/** The number of true literals in each clause. */
-unsigned short *numTrueLit;
-/*the number of clauses the variable i will make unsat if flipped*/
-int *breaks;
-/** critVar[i]=j tells that for clause i the variable j is critically responsible for satisfying i.*/
-int *critVar;
-int bestVar;
-
-/*----probSAT variables----*/
-/** Look-up table for the functions. The values are computed in the initProbSAT method.*/
-double *probsBreak;
-/** contains the probabilities of the variables from an unsatisfied clause*/
-double *probs;
-double cb; //for break
-double eps = 1.0;
-int fct = 0; //function to use 0= poly 1=exp
-int caching = 0;
-/*--------*/
-
-/*----Input file variables----*/
-FILE *fp;
-char *fileName;
-/*---------*/
+/** What the assignment makes of a clause, both counts in one place.
+ * trueVars is the XOR of the variables of its true literals - with one true literal
+ * it is the critical variable, the one that breaks the clause if flipped.*/
+typedef struct {
+	int numTrueLit;
+	int trueVars;
+} clauseState;
+
+/** The state of a solver: the instance, the assignment and the parameters of its runs.
+ * Nothing is shared between contexts, so several may be solved side by side.*/
+struct probsat {
+	/*----Instance data (independent from assignment)----*/
+	/** The numbers of variables. */
+	int numVars;
+	/** The number of clauses. */
+	int numClauses;
+	/** The number of literals. */
+	int numLiterals;
+	/** The value of the variables. The numbering starts at 1 and the possible values are 0 or 1. */
+	char *atom;
+	/** The literals of all clauses, one after another. Clause c (numbered from 0)
+	 * is lits[clauseStart[c]] .. lits[clauseStart[c+1]-1].*/
+	int *lits;
+	int *clauseStart;
+	/**min and max clause length*/
+	int maxClauseSize;
+	int minClauseSize;
+	/** The width of all clauses when they are alike, else 0.*/
+	int width;
+	/** The kernel asked for: -1 the one for width, 0 the general one, or a width.*/
+	int kernel;
+	/** Its vector variant: -1 the fastest the CPU runs, 0 none, else 1 + the index in isaKernels.*/
+	int isa;
+	/** The occurrences from occ16: -1 when there is one, 0 no, 1 yes (a kernel name with /16).*/
+	int narrow;
+	char kernelName[16];
+	/** The clauses where each literal occurs, the same way: literal l occurs in the clauses
+	 * occ[occIx[l]] .. occ[occIx[l+1]-1]. occIx is indexed by the literal itself, -numVars .. numVars+1.*/
+	int *occIx;
+	int *occ;
+	/** occ again in 16 bits, cache line aligned as the arena, when there are at most 65536
+	 * clauses, else NULL; half the bytes the flips read.*/
+	uint16_t *occ16;
+	int maxNumOccurences; //maximum number of occurences for a literal
+	/** Where the arrays above live: mapped from a binary file, or the arena of a parsed one.*/
+	inst_t inst;
+	void *arena;
+	/*--------*/
+
+	/**----Assignment dependent data----*/
+	/** The number of false clauses.*/
+	int numFalse;
+	/** Array containing all clauses that are false. Managed as a list.*/
+	int *falseClause;
+	/** whereFalse[i]=j tells that clause i is listed in falseClause at position j.  */
+	int *whereFalse;
+	/** The number of true literals in each clause and the variables they belong to. */
+	clauseState *cs;
+	/*the number of clauses the variable i will make unsat if flipped*/
+	int *breaks;
+	/*the number of false clauses the variable i will make sat if flipped, only with --cm*/
+	int *makes;
+	int bestVar;
+
+	/*----probSAT variables----*/
+	/** Look-up table for the functions. The values are computed in the initProbSAT method.*/
+	double *probsBreak;
+	/** The function of make, only with --cm.*/
+	double *probsMake;
+	/** The same in fixed point, scaled so that the weights of a clause add up to less than 2^32.*/
+	uint32_t *probsBreakFix;
+	/** probsMake[make]*probsBreak[break] in fixed point, at make*(maxNumOccurences+1)+break.
+	 * Makes over makeMax share the row of makeMax, to keep the table small.*/
+	uint32_t *probsMakeBreakFix;
+	int makeMax;
+	/** contains the weights of the variables from an unsatisfied clause*/
+	uint32_t *probs;
+	double cb; //for break
+	double cm; //for make, used only when cm_spec
+	double eps;
+	int fct; //function to use 0= poly 1=exp
+	int caching;
+	void (*initLookUpTable)(probsat_t *ps);
+	void (*pickAndFlipVar)(probsat_t *ps);
+	void (*initClauses)(probsat_t *ps);
+	/*--------*/
 
-/** Run time variables variables*/BIGINT seed;
-BIGINT maxTries = LLONG_MAX;
-BIGINT maxFlips = LLONG_MAX;
-BIGINT flip;
+	/** Run time variables variables*/
+	BIGINT seed;
+	/** The random numbers of the runs, of this context only.*/
+	rng_state_t rng;
+	BIGINT maxTries;
+	BIGINT maxFlips;
+	BIGINT flip;
+	/** The seconds a run may take, 0 no limit (probsat_set_timeout).*/
+	double timeout;
+	/** A run goes on while *pcont, NULL none (probsat_set_cont).*/
+	probsat_cont_t *pcont;
+	int bestNumFalse;
+	//parameters flags - indicates if the parameters were set on the command line
+	int cm_spec, cb_spec, fct_spec, caching_spec;
+};
+
+/*----Command line only----*/
+char *fileName;
+char *kernelArg = NULL;
 float timeOut = FLT_MAX;
 int run = 1;
 int printSol = 0;
 double tryTime;
 long ticks_per_second;
-int bestNumFalse;
-//parameters flags - indicates if the parameters were set on the command line
-int cm_spec = 0, cb_spec = 0, fct_spec = 0, caching_spec = 0;
+/*---------*/
 
 inline int abs(int a) {
 	return (a < 0) ? -a : a;
 }
 
-void printFormulaProperties() {
+void printFormulaProperties(probsat_t *ps) {
 	printf("\nc %-20s:  %s\n", "instance name", fileName);
-	printf("c %-20s:  %d\n", "number of variables", numVars);
-	printf("c %-20s:  %d\n", "number of literals", numLiterals);
-	printf("c %-20s:  %d\n", "number of clauses", numClauses);
-	printf("c %-20s:  %d\n", "max. clause length", maxClauseSize);
+	printf("c %-20s:  %d\n", "number of variables", ps->numVars);
+	printf("c %-20s:  %d\n", "number of literals", ps->numLiterals);
+	printf("c %-20s:  %d\n", "number of clauses", ps->numClauses);
+	printf("c %-20s:  %d\n", "max. clause length", ps->maxClauseSize);
 }
 
-void printProbs() {
+void printProbs(probsat_t *ps) {
 	int i;
 	printf("c Probs values:\n");
 	printf("c  ");
@@ -117,47 +166,59 @@ void printProbs() {
 
 	printf("\nc b");
 	for (i = 0; i <= 10; i++) {
-		if (probsBreak[i] != 0)
-			printf(" %-6.5f |", probsBreak[i]);
+		if (ps->probsBreak[i] != 0)
+			printf(" %-6.5f |", ps->probsBreak[i]);
 	}
 	printf("\n");
 }
 
-void printSolverParameters() {
+void printSolverParameters(probsat_t *ps) {
 	printf("\nc probSAT parameteres: \n");
-	printf("c %-20s: %-20s\n", "using:", "only break");
-	if (fct == 0)
+	if (ps->cm_spec)
+		printf("c %-20s: %-20s\n", "using:", "make and break");
+	else
+		printf("c %-20s: %-20s\n", "using:", "only break");
+	if (ps->fct == 0)
 		printf("c %-20s: %-20s\n", "using:", "polynomial function");
 	else
 		printf("c %-20s: %-20s\n", "using:", "exponential function");
 
-	printf("c %-20s: %6.6f\n", "cb", cb);
-	if (fct == 0) { //poly
-		printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow((eps + break), -cb);");
-		printf("c %-20s: %6.6f\n", "eps", eps);
+	printf("c %-20s: %6.6f\n", "cb", ps->cb);
+	if (ps->cm_spec)
+		printf("c %-20s: %6.6f\n", "cm", ps->cm);
+	if (ps->fct == 0) { //poly
+		if (ps->cm_spec)
+			printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow((eps + break), -cb)*pow(1 + make, cm);");
+		else
+			printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow((eps + break), -cb);");
+		printf("c %-20s: %6.6f\n", "eps", ps->eps);
 	} else { //exp
-		printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow(cb, -break);");
+		if (ps->cm_spec)
+			printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow(cb, -break)*pow(cm, make);");
+		else
+			printf("c %-20s: %-20s\n", "function:", "probsBreak[break]*probsMake[make] = pow(cb, -break);");
 	}
-	if (caching)
+	if (ps->caching)
 		printf("c %-20s: %-20s\n", "using:", "caching of break values");
 	else
 		printf("c %-20s: %-20s\n", "using:", "no caching of break values");
+	printf("c %-20s: %-20s\n", "kernel:", probsat_kernel(ps));
 	//printProbs();
 	printf("\nc general parameteres: \n");
-	printf("c %-20s: %lli\n", "maxTries", maxTries);
-	printf("c %-20s: %lli\n", "maxFlips", maxFlips);
-	printf("c %-20s: %lli\n", "seed", seed);
+	printf("c %-20s: %lli\n", "maxTries", ps->maxTries);
+	printf("c %-20s: %lli\n", "maxFlips", ps->maxFlips);
+	printf("c %-20s: %lli\n", "seed", ps->seed);
 	printf("c %-20s: \n", "-->Starting solver");
 	fflush(stdout);
 }
 
-void printSolution() {
+void printSolution(probsat_t *ps) {
 	register int i;
 	printf("v ");
-	for (i = 1; i <= numVars; i++) {
+	for (i = 1; i <= ps->numVars; i++) {
 		if (i % 21 == 0)
 			printf("\nv ");
-		if (atom[i] == 1)
+		if (ps->atom[i] == 1)
 			printf("%d ", i);
 		else
 			printf("%d ", -i);
@@ -165,41 +226,136 @@ void printSolution() {
 
 }
 
-static inline void printStatsEndFlip() {
-	if (numFalse < bestNumFalse) {
+static inline void printStatsEndFlip(probsat_t *ps) {
+	if (ps->numFalse < ps->bestNumFalse) {
 		//fprintf(stderr, "%8lli numFalse: %5d\n", flip, numFalse);
-		bestNumFalse = numFalse;
+		ps->bestNumFalse = ps->numFalse;
 	}
 }
 
-static inline void allocateMemory() {
+static inline void allocateMemory(probsat_t *ps) {
 	// Allocating memory for the instance data (independent from the assignment).
-	numLiterals = numVars * 2;
-	atom = (char*) malloc(sizeof(char) * (numVars + 1));
-	clause = (int**) malloc(sizeof(int*) * (numClauses + 1));
-	numOccurrence = (int*) malloc(sizeof(int) * (numLiterals + 1));
-	occurrence = (int**) malloc(sizeof(int*) * (numLiterals + 1));
-	critVar = (int*) malloc(sizeof(int) * (numClauses + 1));
+	ps->numLiterals = ps->numVars * 2;
+	ps->atom = (char*) malloc(sizeof(char) * (ps->numVars + 1 + 3)); //+3: a vector gather reads 4 bytes at any variable
 
 	// Allocating memory for the assignment dependent data.
-	falseClause = (int*) malloc(sizeof(int) * (numClauses + 1));
-	whereFalse = (int*) malloc(sizeof(int) * (numClauses + 1));
-	numTrueLit = (unsigned short*) malloc(sizeof(unsigned short) * (numClauses + 1));
+	ps->falseClause = (int*) malloc(sizeof(int) * (ps->numClauses + 1));
+	ps->whereFalse = (int*) malloc(sizeof(int) * (ps->numClauses + 1));
+	ps->cs = (clauseState*) malloc(sizeof(clauseState) * (ps->numClauses + 1));
+	ps->probs = (uint32_t*) malloc(sizeof(uint32_t) * (ps->numVars + 1));
+	ps->breaks = (int*) malloc(sizeof(int) * (ps->numVars + 1));
+	ps->makes = (int*) malloc(sizeof(int) * (ps->numVars + 1));
 }
 
-static inline void parseFile() {
-	register int i, j;
-	int lit, r;
-	int clauseSize;
+/** A context with the defaults of the command line, no instance yet.*/
+static probsat_t *newContext() {
+	probsat_t *ps = (probsat_t*) calloc(1, sizeof(probsat_t));
+	if (ps == NULL)
+		return NULL;
+	ps->eps = 1.0;
+	ps->kernel = -1;
+	ps->isa = -1;
+	ps->narrow = -1;
+	ps->maxTries = LLONG_MAX;
+	ps->maxFlips = LLONG_MAX;
+	return ps;
+}
+
+/** Releases all that parseFile and initLookUpTable allocated.*/
+void freeMemory(probsat_t *ps) {
+	inst_forget(&ps->inst);
+	free(ps->arena);
+	ps->arena = NULL;
+	free(ps->occ16);
+	ps->occ16 = NULL;
+	free(ps->atom);
+	free(ps->falseClause);
+	free(ps->whereFalse);
+	free(ps->cs);
+	free(ps->probs);
+	free(ps->breaks);
+	free(ps->makes);
+	free(ps->probsMake);
+	ps->probsMake = NULL;
+	free(ps->probsMakeBreakFix);
+	ps->probsMakeBreakFix = NULL;
+	free(ps->probsBreak);
+	ps->probsBreak = NULL;
+	free(ps->probsBreakFix);
+	ps->probsBreakFix = NULL;
+	ps->maxNumOccurences = 0;
+}
+
+/** Takes the clauses and the occurrence index from ps->inst, the properties of the formula along.*/
+static void takeInstance(probsat_t *ps) {
+	int c, lit, n;
+	ps->numVars = ps->inst.vars_no;
+	ps->numClauses = ps->inst.length;
+	ps->lits = ps->inst.body;
+	ps->clauseStart = ps->inst.start;
+	ps->occIx = ps->inst.occ_ix;
+	ps->occ = ps->inst.occ;
+	ps->maxClauseSize = 0;
+	ps->minClauseSize = INT_MAX;
+	for (c = 0; c < ps->numClauses; c++) {
+		n = ps->clauseStart[c + 1] - ps->clauseStart[c];
+		if (n > ps->maxClauseSize)
+			ps->maxClauseSize = n;
+		if (n < ps->minClauseSize)
+			ps->minClauseSize = n;
+	}
+	ps->width = ps->minClauseSize == ps->maxClauseSize ? ps->maxClauseSize : 0;
+	ps->maxNumOccurences = 0;
+	for (lit = -ps->numVars; lit <= ps->numVars; lit++)
+		if (ps->occIx[lit + 1] - ps->occIx[lit] > ps->maxNumOccurences)
+			ps->maxNumOccurences = ps->occIx[lit + 1] - ps->occIx[lit];
+	n = ps->occIx[ps->numVars + 1] - ps->occIx[-ps->numVars];
+	if (ps->numClauses <= UINT16_MAX + 1
+			&& (ps->occ16 = (uint16_t*) aligned_alloc(CACHELINE, (sizeof(uint16_t) * n + CACHELINE) & ~(size_t) (CACHELINE - 1))) != NULL)
+		for (c = 0; c < n; c++)
+			ps->occ16[c] = ps->occ[c];
+	allocateMemory(ps);
+}
+
+/** Reads a binary instance (see cnf2bin) - the clauses and the occurrence index come ready made
+ * and are used where the file is mapped.*/
+static inline int parseBinFile(probsat_t *ps, FILE *fp) {
+	int err = inst_read(&ps->inst, fp, 0);
+	fclose(fp);
+	if (err) {
+		inst_read_fail(err, "c Error");
+		return -1;
+	}
+	takeInstance(ps);
+	return 0;
+}
+
+/** n ints at the next cache line of the arena.*/
+static inline int *carve(char *arena, size_t *top, size_t n) {
+	int *p = (int*) (arena + *top);
+	*top += (n * sizeof(int) + CACHELINE - 1) & ~(size_t) (CACHELINE - 1);
+	return p;
+}
+
+static inline int parseFile(probsat_t *ps, const char *file) {
+	int i, lit, r;
+	int clauseSize, capLits, numLits;
 	int tatom;
+	int *buf, *start, *grown;
+	size_t top;
 	char c;
 	long filePos;
-	fp = NULL;
-	fp = fopen(fileName, "r");
+	char magic[sizeof(INST_BIN_MAGIC)];
+	FILE *fp = fopen(file, "r");
 	if (fp == NULL) {
-		fprintf(stderr, "c Error: Not able to open the file: %s\n", fileName);
-		exit(-1);
+		fprintf(stderr, "c Error: Not able to open the file: %s\n", file);
+		return -1;
+	}
+	if (fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && memcmp(magic, INST_BIN_MAGIC, sizeof(magic)) == 0) {
+		rewind(fp);
+		return parseBinFile(ps, fp);
 	}
+	rewind(fp);
 
 	// Start scanning the header and set numVars and numClauses
 	for (;;) {
@@ -209,152 +365,198 @@ static inline void parseFile() {
 				c = fgetc(fp); //read the complete comment line until a eol is detected.
 			} while ((c != '\n') && (c != EOF));
 		else if (c == 'p') { //p-line detected
-			if ((fscanf(fp, "%*s %d %d", &numVars, &numClauses))) //%*s should match with "cnf"
+			if ((fscanf(fp, "%*s %d %d", &ps->numVars, &ps->numClauses))) //%*s should match with "cnf"
 				break;
 		} else {
 			printf("c No parameter line found! Computing number of atoms and number of clauses from file!\n");
 			r = fseek(fp, -1L, SEEK_CUR); //try to unget c
 			if (r == -1) {
-				fprintf(stderr, "c Error: Not able to seek in file: %s", fileName);
-				exit(-1);
+				fprintf(stderr, "c Error: Not able to seek in file: %s", file);
+				fclose(fp);
+				return -1;
 			}
 			filePos = ftell(fp);
 			if (r == -1) {
-				fprintf(stderr, "c Error: Not able to obtain position in file: %s", fileName);
-				exit(-1);
+				fprintf(stderr, "c Error: Not able to obtain position in file: %s", file);
+				fclose(fp);
+				return -1;
 			}
 
-			numVars = 0;
-			numClauses = 0;
+			ps->numVars = 0;
+			ps->numClauses = 0;
 			for (; fscanf(fp, "%i", &lit) == 1;) {
 				if (lit == 0)
-					numClauses++;
+					ps->numClauses++;
 				else {
 					tatom = abs(lit);
-					if (tatom > numVars)
-						numVars = tatom;
+					if (tatom > ps->numVars)
+						ps->numVars = tatom;
 				}
 			}
-			printf("c numVars: %d numClauses: %d\n", numVars, numClauses);
+			printf("c numVars: %d numClauses: %d\n", ps->numVars, ps->numClauses);
 
 			r = fseek(fp, filePos, SEEK_SET); //try to rewind the file to the beginning of the formula
 			if (r == -1) {
-				fprintf(stderr, "c Error: Not able to seek in file: %s", fileName);
-				exit(-1);
+				fprintf(stderr, "c Error: Not able to seek in file: %s", file);
+				fclose(fp);
+				return -1;
 			}
 
 			break;
 		}
 	}
 	// Finished scanning header.
-	//allocating memory to use!
-	allocateMemory();
-	maxClauseSize = 0;
-	minClauseSize = MAXCLAUSELENGTH;
-	int *numOccurrenceT = (int*) malloc(sizeof(int) * (numLiterals + 1));
-
-	int freeStore = 0;
-	int *tempClause = 0;
-	for (i = 0; i < numLiterals + 1; i++) {
-		numOccurrence[i] = 0;
-		numOccurrenceT[i] = 0;
-	}
-
-	for (i = 1; i <= numClauses; i++) {
-		whereFalse[i] = -1;
-		if (freeStore < MAXCLAUSELENGTH) {
-			tempClause = (int*) malloc(sizeof(int) * STOREBLOCK);
-			freeStore = STOREBLOCK;
-		}
-		clause[i] = tempClause;
+	//the literals as they come, then all in one arena
+	capLits = 4 * ps->numClauses + 16;
+	numLits = 0;
+	buf = (int*) malloc(sizeof(int) * capLits);
+	start = (int*) malloc(sizeof(int) * (ps->numClauses + 1));
+	if (buf == NULL || start == NULL) {
+		fprintf(stderr, "c Error: Not enough memory for: %s\n", file);
+		free(buf);
+		free(start);
+		fclose(fp);
+		return -1;
+	}
+	for (i = 0; i < ps->numClauses; i++) {
+		start[i] = numLits;
 		clauseSize = 0;
-		do {
+		for (;;) {
 			r = fscanf(fp, "%i", &lit);
-			if (lit != 0) {
-				clauseSize++;
-				*tempClause++ = lit;
-				numOccurrenceT[numVars + lit]++;
-			} else {
-				*tempClause++ = 0; //0 sentinel as literal!
+			if (r != 1) {
+				fprintf(stderr, "c Error: Clause %d incomplete in file: %s\n", i + 1, file);
+				free(buf);
+				free(start);
+				fclose(fp);
+				return -1;
+			}
+			if (lit == 0)
+				break;
+			if (lit < -ps->numVars || lit > ps->numVars) {
+				fprintf(stderr, "c Error: literal out of range in clause %d of file: %s\n", i + 1, file);
+				free(buf);
+				free(start);
+				fclose(fp);
+				return -1;
+			}
+			if (numLits == capLits) {
+				capLits *= 2;
+				grown = (int*) realloc(buf, sizeof(int) * capLits);
+				if (grown == NULL) {
+					fprintf(stderr, "c Error: Not enough memory for: %s\n", file);
+					free(buf);
+					free(start);
+					fclose(fp);
+					return -1;
+				}
+				buf = grown;
 			}
-			freeStore--;
-		} while (lit != 0);
-		if (clauseSize > maxClauseSize)
-			maxClauseSize = clauseSize;
-		if (clauseSize < minClauseSize)
-			minClauseSize = clauseSize;
-	}
-
-	for (i = 0; i < numLiterals + 1; i++) {
-		occurrence[i] = (int*) malloc(sizeof(int) * (numOccurrenceT[i] + 1));
-		occurrence[i][numOccurrenceT[i]] = 0; //sentinal at the end!
-		if (numOccurrenceT[i] > maxNumOccurences)
-			maxNumOccurences = numOccurrenceT[i];
-	}
-
-	for (i = 1; i <= numClauses; i++) {
-		j = 0;
-		while ((lit = clause[i][j])) {
-			occurrence[lit + numVars][numOccurrence[lit + numVars]++] = i;
-			j++;
+			buf[numLits++] = lit;
+			clauseSize++;
 		}
-		occurrence[lit + numVars][numOccurrence[lit + numVars]] = 0; //sentinel at the end!
 	}
-	probs = (double*) malloc(sizeof(double) * (numVars + 1));
-	breaks = (int*) malloc(sizeof(int) * (numVars + 1));
-	free(numOccurrenceT);
+	start[ps->numClauses] = numLits;
 	fclose(fp);
+
+	top = 0; //sizes first, to allocate once
+	carve(NULL, &top, numLits);
+	carve(NULL, &top, ps->numClauses + 1);
+	carve(NULL, &top, 2 * ps->numVars + 2);
+	carve(NULL, &top, numLits);
+	ps->arena = aligned_alloc(CACHELINE, top > 0 ? top : CACHELINE);
+	if (ps->arena == NULL) {
+		fprintf(stderr, "c Error: Not enough memory for: %s\n", file);
+		free(buf);
+		free(start);
+		return -1;
+	}
+	top = 0;
+	ps->inst.vars_no = ps->numVars;
+	ps->inst.length = ps->numClauses;
+	ps->inst.lits_no = numLits;
+	ps->inst.body = carve(ps->arena, &top, numLits);
+	ps->inst.start = carve(ps->arena, &top, ps->numClauses + 1);
+	ps->inst.occ_ix = carve(ps->arena, &top, 2 * ps->numVars + 2) + ps->numVars;
+	ps->inst.occ = carve(ps->arena, &top, numLits);
+	ps->inst.shared = 1; //the arena is freed on its own
+	memcpy(ps->inst.body, buf, sizeof(int) * numLits);
+	memcpy(ps->inst.start, start, sizeof(int) * (ps->numClauses + 1));
+	free(buf);
+	free(start);
+	memset(ps->inst.occ_ix - ps->numVars, 0, sizeof(int) * (2 * ps->numVars + 2));
+	inst_occ_fill(&ps->inst, ps->inst.occ_ix, ps->inst.occ);
+	takeInstance(ps);
+	return 0;
 }
 
-static inline void init() {
-	ticks_per_second = sysconf(_SC_CLK_TCK);
+/** A random assignment for a new try; ps->initClauses makes the clause states, the break
+ * and make values and the false clauses of it.*/
+static inline void init(probsat_t *ps) {
+	register int i;
+	ps->numFalse = 0;
+	rng_bits_t bits = RNG_BITS_INIT;
+	for (i = 1; i <= ps->numVars; i++) {
+		ps->atom[i] = rng_next_bit_r(&ps->rng, &bits);
+		ps->breaks[i] = 0;
+		ps->makes[i] = 0;
+	}
+	ps->initClauses(ps);
+}
+
+/** What clause i is under the assignment, numTrueLit and trueVars found already.*/
+static inline void initClause(probsat_t *ps, int i, int numTrueLit, int trueVars, const int w) {
+	register int j;
+	const int *cl;
+	ps->cs[i].numTrueLit = numTrueLit;
+	ps->cs[i].trueVars = trueVars;
+	ps->whereFalse[i] = -1;
+	if (numTrueLit == 1) {
+		//if the clause has only one literal that causes it to be sat,
+		//then this var. will break the sat of the clause if flipped.
+		ps->breaks[trueVars]++;
+	} else if (numTrueLit == 0) {
+		//add this clause to the list of unsat caluses.
+		ps->falseClause[ps->numFalse] = i;
+		ps->whereFalse[i] = ps->numFalse;
+		ps->numFalse++;
+		cl = CLAUSE(ps, i, w);
+		for (j = 0; j < CLAUSELEN(ps, i, w); j++)
+			ps->makes[abs(cl[j])]++;
+	}
+}
+
+//pass trough the clauses from the one given on and apply the assignment previously generated, clauses of width w
+static inline void initClausesW(probsat_t *ps, int from, const int w) {
 	register int i, j;
-	int critLit = 0, lit;
-	numFalse = 0;
-	for (i = 1; i <= numClauses; i++) {
-		numTrueLit[i] = 0;
-		whereFalse[i] = -1;
-	}
-
-	for (i = 1; i <= numVars; i++) {
-		atom[i] = rand() % 2;
-		breaks[i] = 0;
-	}
-	//pass trough all clauses and apply the assignment previously generated
-	for (i = 1; i <= numClauses; i++) {
-		j = 0;
-		while ((lit = clause[i][j])) {
-			if (atom[abs(lit)] == (lit > 0)) {
-				numTrueLit[i]++;
-				critLit = lit;
-			}
-			j++;
-		}
-		if (numTrueLit[i] == 1) {
-			//if the clause has only one literal that causes it to be sat,
-			//then this var. will break the sat of the clause if flipped.
-			critVar[i] = abs(critLit);
-			breaks[abs(critLit)]++;
-		} else if (numTrueLit[i] == 0) {
-			//add this clause to the list of unsat caluses.
-			falseClause[numFalse] = i;
-			whereFalse[i] = numFalse;
-			numFalse++;
+	int lit, len, numTrueLit, trueVars, t;
+	const int *cl;
+	for (i = from; i < ps->numClauses; i++) {
+		numTrueLit = trueVars = 0;
+		cl = CLAUSE(ps, i, w);
+		len = CLAUSELEN(ps, i, w);
+		for (j = 0; j < len; j++) {
+			lit = cl[j];
+			t = ps->atom[abs(lit)] == (lit > 0); //without a branch, it would be mispredicted half the time
+			numTrueLit += t;
+			trueVars ^= -t & abs(lit);
 		}
+		initClause(ps, i, numTrueLit, trueVars, w);
 	}
 }
 
-/** Checks whether the assignment from atom is a satisfying assignment.*/
-static inline int checkAssignment() {
+/** Checks whether the assignment from atom is a satisfying assignment, clauses of width w.*/
+static inline int checkAssignmentW(probsat_t *ps, const int w) {
 	register int i, j;
-	int sat, lit;
-	for (i = 1; i <= numClauses; i++) {
+	int sat, lit, len;
+	const int *cl;
+	for (i = 0; i < ps->numClauses; i++) {
 		sat = 0;
-		j = 0;
-		while ((lit = clause[i][j])) {
-			if (atom[abs(lit)] == (lit > 0))
+		cl = CLAUSE(ps, i, w);
+		len = CLAUSELEN(ps, i, w);
+		for (j = 0; j < len; j++) {
+			lit = cl[j];
+			if (ps->atom[abs(lit)] == (lit > 0))
 				sat = 1;
-			j++;
 		}
 		if (sat == 0)
 			return 0;
@@ -362,156 +564,360 @@ static inline int checkAssignment() {
 	return 1;
 }
 
+/** Checks whether the assignment from atom is a satisfying assignment.*/
+static int checkAssignment(probsat_t *ps) {
+	switch (ps->width) {
+	case 3:
+		return checkAssignmentW(ps, 3);
+	case 4:
+		return checkAssignmentW(ps, 4);
+	case 5:
+		return checkAssignmentW(ps, 5);
+	case 7:
+		return checkAssignmentW(ps, 7);
+	default:
+		return checkAssignmentW(ps, 0);
+	}
+}
+
+/** Clause j of the occurrences, from occ16 in the narrow kernels (n 1), inlined with n constant as w.*/
+#define OCC(ps, j, n) ((n) ? (int) (ps)->occ16[j] : (ps)->occ[j])
+
 //go trough the unsat clauses with the flip counter and DO NOT pick RANDOM unsat clause!!
 // do not cache the break values but compute them on the fly (this is also the default implementation of WalkSAT in UBCSAT)
-static inline void pickAndFlipNC() {
+static inline void pickAndFlipNCW(probsat_t *ps, const int w, const int n) {
 	register int i, j;
 	int bestVar;
-	int rClause, tClause;
-	rClause = falseClause[flip % numFalse]; //random unsat clause
-	bestVar = abs(clause[rClause][0]);
-	double randPosition;
+	int rClause, tClause, len;
+	const int *occIx = ps->occIx, *cl;
+	clauseState *cs = ps->cs;
+	rClause = ps->falseClause[ps->flip % ps->numFalse]; //random unsat clause
+	cl = CLAUSE(ps, rClause, w);
+	len = CLAUSELEN(ps, rClause, w);
+	uint32_t randPosition;
 	int lit;
-	double sumProb = 0;
+	uint32_t sumProb = 0;
 	int xMakesSat = 0;
-	i = 0;
-	while ((lit = clause[rClause][i])) {
-		breaks[i] = 0;
-		//lit = clause[rClause][i];
-		//numOccurenceX = numOccurrence[numVars - lit]; //only the negated occurrence of lit will count for break
-		j=0;
-		while ((tClause = occurrence[numVars - lit][j])){
-			if (numTrueLit[tClause] == 1)
-				breaks[i]++;
-			j++;
-		}
-		probs[i] = probsBreak[breaks[i]];
-		sumProb += probs[i];
-		i++;
+	for (i = 0; i < len; i++) {
+		lit = cl[i];
+		ps->breaks[i] = 0;
+		//only the negated occurrence of lit will count for break
+		for (j = occIx[-lit]; j < occIx[-lit + 1]; j++)
+			if (cs[OCC(ps, j, n)].numTrueLit == 1)
+				ps->breaks[i]++;
+		ps->probs[i] = ps->probsBreakFix[ps->breaks[i]];
+		sumProb += ps->probs[i];
 	}
-	randPosition = (double) (rand()) / RAND_MAX * sumProb;
-	for (i = i - 1; i != 0; i--) {
-		sumProb -= probs[i];
+	randPosition = rng_next_scale_r(&ps->rng, sumProb); //0 .. sumProb-1, one integer draw
+	for (i = len - 1; i != 0; i--) {
+		sumProb -= ps->probs[i];
 		if (sumProb <= randPosition)
 			break;
 	}
-	bestVar = abs(clause[rClause][i]);
+	bestVar = abs(cl[i]);
 
 	//flip bestvar
-	if (atom[bestVar])
+	if (ps->atom[bestVar])
 		xMakesSat = -bestVar; //if x=1 then all clauses containing -x will be made sat after fliping x
 	else
 		xMakesSat = bestVar; //if x=0 then all clauses containing x will be made sat after fliping x
-	atom[bestVar] = 1 - atom[bestVar];
+	ps->atom[bestVar] = 1 - ps->atom[bestVar];
 	//1. Clauses that contain xMakeSAT will get SAT if not already SAT
-	//numOccurenceX = numOccurrence[numVars + xMakesSat];
-	i = 0;
-	while ((tClause = occurrence[xMakesSat + numVars][i])) {
+	for (i = occIx[xMakesSat]; i < occIx[xMakesSat + 1]; i++) {
+		tClause = OCC(ps, i, n);
 		//if the clause is unsat it will become SAT so it has to be removed from the list of unsat-clauses.
-		if (numTrueLit[tClause] == 0) {
+		if (cs[tClause].numTrueLit == 0) {
 			//remove from unsat-list
-			falseClause[whereFalse[tClause]] = falseClause[--numFalse]; //overwrite this clause with the last clause in the list.
-			whereFalse[falseClause[numFalse]] = whereFalse[tClause];
-			whereFalse[tClause] = -1;
+			ps->falseClause[ps->whereFalse[tClause]] = ps->falseClause[--ps->numFalse]; //overwrite this clause with the last clause in the list.
+			ps->whereFalse[ps->falseClause[ps->numFalse]] = ps->whereFalse[tClause];
+			ps->whereFalse[tClause] = -1;
 		}
-		numTrueLit[tClause]++; //the number of true Lit is increased.
-		i++;
+		cs[tClause].numTrueLit++; //the number of true Lit is increased. trueVars is not needed here
 	}
 	//2. all clauses that contain the literal -xMakesSat=0 will not be longer satisfied by variable x.
 	//all this clauses contained x as a satisfying literal
-	//numOccurenceX = numOccurrence[numVars - xMakesSat];
-	i = 0;
-	while ((tClause = occurrence[numVars - xMakesSat][i])) {
-		if (numTrueLit[tClause] == 1) { //then xMakesSat=1 was the satisfying literal.
-			falseClause[numFalse] = tClause;
-			whereFalse[tClause] = numFalse;
-			numFalse++;
+	for (i = occIx[-xMakesSat]; i < occIx[-xMakesSat + 1]; i++) {
+		tClause = OCC(ps, i, n);
+		if (cs[tClause].numTrueLit == 1) { //then xMakesSat=1 was the satisfying literal.
+			ps->falseClause[ps->numFalse] = tClause;
+			ps->whereFalse[tClause] = ps->numFalse;
+			ps->numFalse++;
 		}
-		numTrueLit[tClause]--;
-		i++;
+		cs[tClause].numTrueLit--;
 	}
 	//fliping done!
 }
-static inline void pickAndFlip() {
+static inline void pickAndFlipW(probsat_t *ps, const int w, const int n) {
 	int var;
-	int rClause = falseClause[flip % numFalse];
-	double sumProb = 0.0;
-	double randPosition;
-	register int i, j;
+	int rClause = ps->falseClause[ps->flip % ps->numFalse];
+	uint32_t sumProb = 0;
+	uint32_t randPosition;
+	register int i;
 	int tClause; //temporary clause variable
 	int xMakesSat; //tells which literal of x will make the clauses where it appears sat.
-	i = 0;
-	while ((var = abs(clause[rClause][i]))) {
-		probs[i] = probsBreak[breaks[var]];
-		sumProb += probs[i];
-		i++;
-	}
-	randPosition = (double) (rand()) / RAND_MAX * sumProb;
-	for (i = i - 1; i != 0; i--) {
-		sumProb -= probs[i];
+	int len;
+	const int *occIx = ps->occIx, *cl;
+	int *breaks = ps->breaks;
+	clauseState *cs = ps->cs, *c;
+	cl = CLAUSE(ps, rClause, w);
+	len = CLAUSELEN(ps, rClause, w);
+	for (i = 0; i < len; i++) {
+		ps->probs[i] = ps->probsBreakFix[breaks[abs(cl[i])]];
+		sumProb += ps->probs[i];
+	}
+	randPosition = rng_next_scale_r(&ps->rng, sumProb); //0 .. sumProb-1, one integer draw
+	for (i = len - 1; i != 0; i--) {
+		sumProb -= ps->probs[i];
 		if (sumProb <= randPosition)
 			break;
 	}
-	bestVar = abs(clause[rClause][i]);
+	ps->bestVar = abs(cl[i]);
 
-	if (atom[bestVar] == 1)
-		xMakesSat = -bestVar; //if x=1 then all clauses containing -x will be made sat after fliping x
+	if (ps->atom[ps->bestVar] == 1)
+		xMakesSat = -ps->bestVar; //if x=1 then all clauses containing -x will be made sat after fliping x
 	else
-		xMakesSat = bestVar; //if x=0 then all clauses containing x will be made sat after fliping x
+		xMakesSat = ps->bestVar; //if x=0 then all clauses containing x will be made sat after fliping x
 
-	atom[bestVar] = 1 - atom[bestVar];
+	ps->atom[ps->bestVar] = 1 - ps->atom[ps->bestVar];
+	var = ps->bestVar;
 
 	//1. all clauses that contain the literal xMakesSat will become SAT, if they where not already sat.
-	i = 0;
-	while ((tClause = occurrence[xMakesSat + numVars][i])) {
+	for (i = occIx[xMakesSat]; i < occIx[xMakesSat + 1]; i++) {
+		tClause = OCC(ps, i, n);
+		c = cs + tClause;
 		//if the clause is unsat it will become SAT so it has to be removed from the list of unsat-clauses.
-		if (numTrueLit[tClause] == 0) {
+		if (c->numTrueLit == 0) {
 			//remove from unsat-list
-			falseClause[whereFalse[tClause]] = falseClause[--numFalse]; //overwrite this clause with the last clause in the list.
-			whereFalse[falseClause[numFalse]] = whereFalse[tClause];
-			whereFalse[tClause] = -1;
-			critVar[tClause] = abs(xMakesSat); //this variable is now critically responsible for satisfying tClause
+			ps->falseClause[ps->whereFalse[tClause]] = ps->falseClause[--ps->numFalse]; //overwrite this clause with the last clause in the list.
+			ps->whereFalse[ps->falseClause[ps->numFalse]] = ps->whereFalse[tClause];
+			ps->whereFalse[tClause] = -1;
 			//adapt the scores of the variables
 			//the score of x has to be decreased by one because x is critical and will break this clause if fliped.
-			breaks[bestVar]++;
+			breaks[var]++;
 		} else {
 			//if the clause is satisfied by only one literal then the score has to be increased by one for this var.
 			//because fliping this variable will no longer break the clause
-			if (numTrueLit[tClause] == 1) {
-				breaks[critVar[tClause]]--;
+			if (c->numTrueLit == 1) {
+				breaks[c->trueVars]--;
 			}
 		}
-		//if the number of numTrueLit[tClause]>=2 then nothing will change in the scores
-		numTrueLit[tClause]++; //the number of true Lit is increased.
-		i++;
+		//if the number of numTrueLit>=2 then nothing will change in the scores
+		c->numTrueLit++; //the number of true Lit is increased.
+		c->trueVars ^= var;
 	}
 	//2. all clauses that contain the literal -xMakesSat=0 will not be longer satisfied by variable x.
 	//all this clauses contained x as a satisfying literal
-	i = 0;
-	while ((tClause = occurrence[numVars - xMakesSat][i])) {
-		if (numTrueLit[tClause] == 1) { //then xMakesSat=1 was the satisfying literal.
+	for (i = occIx[-xMakesSat]; i < occIx[-xMakesSat + 1]; i++) {
+		tClause = OCC(ps, i, n);
+		c = cs + tClause;
+		c->trueVars ^= var; //x is no longer among the true literals
+		if (c->numTrueLit == 1) { //then xMakesSat=1 was the satisfying literal.
 			//this clause gets unsat.
-			falseClause[numFalse] = tClause;
-			whereFalse[tClause] = numFalse;
-			numFalse++;
+			ps->falseClause[ps->numFalse] = tClause;
+			ps->whereFalse[tClause] = ps->numFalse;
+			ps->numFalse++;
 			//the score of x has to be increased by one because it is not breaking any more for this clause.
-			breaks[bestVar]--;
+			breaks[var]--;
 			//the scores of all variables have to be increased by one ; inclusive x because flipping them will make the clause again sat
-		} else if (numTrueLit[tClause] == 2) { //find which literal is true and make it critical and decrease its score
-			j = 0;
-			while ((var = abs(clause[tClause][j]))) {
-				if (((clause[tClause][j] > 0) == atom[abs(var)])) { //x can not be the var anymore because it was flipped //&&(xMakesSat!=var)
-					critVar[tClause] = var;
-					breaks[var]++;
-					break;
-				}
-				j++;
-			}
+		} else if (c->numTrueLit == 2) { //the one true literal left is critical now, its variable is what remains of trueVars
+			breaks[c->trueVars]++;
+		}
+		c->numTrueLit--;
+	}
+
+}
+
+/** The width kernels and the general ones, each also narrow, chosen by setupParameters.*/
+#define WIDTH_KERNELS(w) \
+	static void pickAndFlipNC##w(probsat_t *ps) { pickAndFlipNCW(ps, w, 0); } \
+	static void pickAndFlip##w(probsat_t *ps) { pickAndFlipW(ps, w, 0); } \
+	static void pickAndFlipNC##w##Narrow(probsat_t *ps) { pickAndFlipNCW(ps, w, 1); } \
+	static void pickAndFlip##w##Narrow(probsat_t *ps) { pickAndFlipW(ps, w, 1); } \
+	static void initClauses##w(probsat_t *ps) { initClausesW(ps, 0, w); }
+WIDTH_KERNELS(3)
+WIDTH_KERNELS(4)
+WIDTH_KERNELS(5)
+WIDTH_KERNELS(7)
+static void pickAndFlipNC(probsat_t *ps) {
+	pickAndFlipNCW(ps, 0, 0);
+}
+static void pickAndFlip(probsat_t *ps) {
+	pickAndFlipW(ps, 0, 0);
+}
+static void pickAndFlipNCNarrow(probsat_t *ps) {
+	pickAndFlipNCW(ps, 0, 1);
+}
+static void pickAndFlipNarrow(probsat_t *ps) {
+	pickAndFlipW(ps, 0, 1);
+}
+static void initClauses(probsat_t *ps) {
+	initClausesW(ps, 0, 0);
+}
+static void (* const pickAndFlipNCWidth[8])(probsat_t *ps) = { [3] = pickAndFlipNC3, [4] = pickAndFlipNC4, [5] = pickAndFlipNC5, [7] = pickAndFlipNC7 };
+static void (* const pickAndFlipWidth[8])(probsat_t *ps) = { [3] = pickAndFlip3, [4] = pickAndFlip4, [5] = pickAndFlip5, [7] = pickAndFlip7 };
+static void (* const pickAndFlipNCWidthNarrow[8])(probsat_t *ps) = { [3] = pickAndFlipNC3Narrow, [4] = pickAndFlipNC4Narrow,
+		[5] = pickAndFlipNC5Narrow, [7] = pickAndFlipNC7Narrow };
+static void (* const pickAndFlipWidthNarrow[8])(probsat_t *ps) = { [3] = pickAndFlip3Narrow, [4] = pickAndFlip4Narrow,
+		[5] = pickAndFlip5Narrow, [7] = pickAndFlip7Narrow };
+static void (* const initClausesWidth[8])(probsat_t *ps) = { [3] = initClauses3, [4] = initClauses4, [5] = initClauses5, [7] = initClauses7 };
+
+/** initClauses in vectors, 8 (AVX2) or 16 (AVX-512) clauses of width ps->width at a time: literal j
+ * of each gathered from lits by a stride of the width, the value of its variable from atom by a
+ * 4 byte read (atom is padded for it). The clauses are then taken in order as by initClausesW,
+ * so the false clauses are listed the same and the search stays the same.*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PROBSAT_X86
+
+__attribute__((target("avx2")))
+static void initClausesAVX2(probsat_t *ps) {
+	int i, j, l, w = ps->width;
+	int nums[8] __attribute__((aligned(32))), vars[8] __attribute__((aligned(32)));
+	__m256i ix = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(w));
+	__m256i low = _mm256_set1_epi32(0xFF), one = _mm256_set1_epi32(1), zero = _mm256_setzero_si256();
+	__m256i num, tv, lit, var, t;
+	for (i = 0; i + 8 <= ps->numClauses; i += 8) {
+		num = tv = zero;
+		for (j = 0; j < w; j++) {
+			lit = _mm256_i32gather_epi32(ps->lits + i * w + j, ix, 4);
+			var = _mm256_abs_epi32(lit);
+			t = _mm256_and_si256(_mm256_i32gather_epi32((const int*) ps->atom, var, 1), low);
+			t = _mm256_cmpeq_epi32(t, _mm256_and_si256(_mm256_cmpgt_epi32(lit, zero), one)); //the literal is true
+			num = _mm256_sub_epi32(num, t);
+			tv = _mm256_xor_si256(tv, _mm256_and_si256(t, var));
 		}
-		numTrueLit[tClause]--;
-		i++;
+		_mm256_store_si256((__m256i*) nums, num);
+		_mm256_store_si256((__m256i*) vars, tv);
+		for (l = 0; l < 8; l++)
+			initClause(ps, i + l, nums[l], vars[l], w);
+	}
+	initClausesW(ps, i, w); //the last few
+}
+__attribute__((target("avx512f")))
+static void initClausesAVX512(probsat_t *ps) {
+	int i, j, l, w = ps->width;
+	int nums[16] __attribute__((aligned(64))), vars[16] __attribute__((aligned(64)));
+	__m512i ix = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(w));
+	__m512i low = _mm512_set1_epi32(0xFF), one = _mm512_set1_epi32(1), zero = _mm512_setzero_si512();
+	__m512i num, tv, lit, var;
+	__mmask16 t;
+	for (i = 0; i + 16 <= ps->numClauses; i += 16) {
+		num = tv = zero;
+		for (j = 0; j < w; j++) {
+			lit = _mm512_i32gather_epi32(ix, ps->lits + i * w + j, 4);
+			var = _mm512_abs_epi32(lit);
+			t = _mm512_cmpeq_epi32_mask(_mm512_and_si512(_mm512_i32gather_epi32(var, ps->atom, 1), low),
+					_mm512_maskz_mov_epi32(_mm512_cmpgt_epi32_mask(lit, zero), one)); //the literal is true
+			num = _mm512_mask_add_epi32(num, t, num, one);
+			tv = _mm512_mask_xor_epi32(tv, t, tv, var);
+		}
+		_mm512_store_si512(nums, num);
+		_mm512_store_si512(vars, tv);
+		for (l = 0; l < 16; l++)
+			initClause(ps, i + l, nums[l], vars[l], w);
+	}
+	initClausesW(ps, i, w);
+}
+static int hasAVX512(void) {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx512f");
+}
+static int hasAVX2(void) {
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+}
+#endif
+
+/** The vector variants of the width kernels, the fastest first. Which the CPU runs is found
+ * out at run time, so that one build serves all.*/
+typedef struct {
+	const char *name;
+	int (*has)(void);
+	void (*initClauses)(probsat_t *ps);
+} isaKernel;
+static const isaKernel isaKernels[] = {
+#ifdef PROBSAT_X86
+		{ "avx512", hasAVX512, initClausesAVX512 }, { "avx2", hasAVX2, initClausesAVX2 },
+#endif
+		{ NULL, NULL, NULL } };
+
+/** pickAndFlip with the make values cached as well: makes[v] is the number of false clauses
+ * v occurs in, kept up to date when a clause turns false or true. The weight of a variable
+ * is probsMakeBreakFix[make][break] (--cm).*/
+static inline void pickAndFlipCM(probsat_t *ps) {
+	int var;
+	int rClause = ps->falseClause[ps->flip % ps->numFalse];
+	uint32_t sumProb = 0;
+	uint32_t randPosition;
+	register int i, j;
+	int tClause; //temporary clause variable
+	int xMakesSat; //tells which literal of x will make the clauses where it appears sat.
+	int len, make;
+	const int *lits = ps->lits, *clauseStart = ps->clauseStart, *occ = ps->occ, *occIx = ps->occIx, *cl;
+	const int stride = ps->maxNumOccurences + 1, makeMax = ps->makeMax;
+	int *breaks = ps->breaks, *makes = ps->makes;
+	clauseState *cs = ps->cs, *c;
+	cl = lits + clauseStart[rClause];
+	len = clauseStart[rClause + 1] - clauseStart[rClause];
+	for (i = 0; i < len; i++) {
+		var = abs(cl[i]);
+		make = makes[var] < makeMax ? makes[var] : makeMax;
+		ps->probs[i] = ps->probsMakeBreakFix[make * stride + breaks[var]];
+		sumProb += ps->probs[i];
 	}
+	randPosition = rng_next_scale_r(&ps->rng, sumProb); //0 .. sumProb-1, one integer draw
+	for (i = len - 1; i != 0; i--) {
+		sumProb -= ps->probs[i];
+		if (sumProb <= randPosition)
+			break;
+	}
+	ps->bestVar = abs(cl[i]);
+
+	if (ps->atom[ps->bestVar] == 1)
+		xMakesSat = -ps->bestVar; //if x=1 then all clauses containing -x will be made sat after fliping x
+	else
+		xMakesSat = ps->bestVar; //if x=0 then all clauses containing x will be made sat after fliping x
 
+	ps->atom[ps->bestVar] = 1 - ps->atom[ps->bestVar];
+	var = ps->bestVar;
+
+	//1. all clauses that contain the literal xMakesSat will become SAT, if they where not already sat.
+	for (i = occIx[xMakesSat]; i < occIx[xMakesSat + 1]; i++) {
+		tClause = occ[i];
+		c = cs + tClause;
+		if (c->numTrueLit == 0) {
+			//remove from unsat-list
+			ps->falseClause[ps->whereFalse[tClause]] = ps->falseClause[--ps->numFalse]; //overwrite this clause with the last clause in the list.
+			ps->whereFalse[ps->falseClause[ps->numFalse]] = ps->whereFalse[tClause];
+			ps->whereFalse[tClause] = -1;
+			//no variable of the clause makes it any more, x included
+			for (j = clauseStart[tClause]; j < clauseStart[tClause + 1]; j++)
+				makes[abs(lits[j])]--;
+			breaks[var]++;
+		} else if (c->numTrueLit == 1) {
+			breaks[c->trueVars]--;
+		}
+		c->numTrueLit++; //the number of true Lit is increased.
+		c->trueVars ^= var;
+	}
+	//2. all clauses that contain the literal -xMakesSat=0 will not be longer satisfied by variable x.
+	for (i = occIx[-xMakesSat]; i < occIx[-xMakesSat + 1]; i++) {
+		tClause = occ[i];
+		c = cs + tClause;
+		c->trueVars ^= var; //x is no longer among the true literals
+		if (c->numTrueLit == 1) { //then xMakesSat=1 was the satisfying literal.
+			//this clause gets unsat, flipping any of its variables makes it again sat
+			ps->falseClause[ps->numFalse] = tClause;
+			ps->whereFalse[tClause] = ps->numFalse;
+			ps->numFalse++;
+			for (j = clauseStart[tClause]; j < clauseStart[tClause + 1]; j++)
+				makes[abs(lits[j])]++;
+			breaks[var]--;
+		} else if (c->numTrueLit == 2) { //the one true literal left is critical now
+			breaks[c->trueVars]++;
+		}
+		c->numTrueLit--;
+	}
 }
 
 double elapsed_seconds(void) {
@@ -524,12 +930,12 @@ double elapsed_seconds(void) {
 	return answer;
 }
 
-static inline void printEndStatistics() {
+static inline void printEndStatistics(probsat_t *ps) {
 	printf("\nc EndStatistics:\n");
-	printf("c %-30s: %-9lli\n", "numFlips", flip);
-	printf("c %-30s: %-8.2f\n", "avg. flips/variable", (double) flip / (double) numVars);
-	printf("c %-30s: %-8.2f\n", "avg. flips/clause", (double) flip / (double) numClauses);
-	printf("c %-30s: %-8.0f\n", "flips/sec", (double) flip / tryTime);
+	printf("c %-30s: %-9lli\n", "numFlips", ps->flip);
+	printf("c %-30s: %-8.2f\n", "avg. flips/variable", (double) ps->flip / (double) ps->numVars);
+	printf("c %-30s: %-8.2f\n", "avg. flips/clause", (double) ps->flip / (double) ps->numClauses);
+	printf("c %-30s: %-8.0f\n", "flips/sec", (double) ps->flip / tryTime);
 	printf("c %-30s: %-8.4f\n", "CPU Time", tryTime);
 }
 
@@ -542,46 +948,175 @@ static inline void printUsage() {
 	printf("----------------------------------------------------------\n");
 	printf("\nUsage of probSAT:\n");
 	printf("./probSAT [options] <DIMACS CNF instance> [<seed>]\n");
+	printf("<seed>: decimal, the same as -r with it in hex [default = time]\n");
 	printf("\nprobSAT options:\n");
 	printf("which function to use:\n");
 	printf("--fct <0,1> : 0 =  polynomial; 1 = exponential [default = 0]\n");
 	printf("--eps <double_value> : eps>0 (only valid when --fct 0)[default = 1.0]\n");
 	printf("which constant to use in the functions:\n");
 	printf("--cb <double_value> : constant for break [default = k dependet]\n");
+	printf("--cm <double_value> : constant for make, caches make values and uses them [default = only break]\n");
+	printf("--kernel <name> : generic, w3, w4, w5, w7, these with -avx2 or -avx512, any with /16 for 16 bit clause indices [default = auto, fitting the instance and the CPU]\n");
 	printf("\nFurther options:\n");
 	printf("--caching <0,1>, -c<0,1>  : use caching of break values \n");
-	printf("--runs <int_value>, -r<int_value>  : maximum number of tries \n");
+	printf("--runs <int_value>, -t<int_value>  : maximum number of tries \n");
 	printf("--maxflips <int_value> , -m<int_value>: number of flips per try \n");
 	printf("--printSolution, -a : output assignment\n");
 	printf("--help, -h : output this help\n");
+	printf("%s", rng_synopsis);
 	printf("----------------------------------------------------------\n\n");
 }
 
-void initPoly() {
+/** probsBreakFix from probsBreak: the largest value becomes (2^32-1)/maxClauseSize, so the sum over
+ * any clause fits 32 bits; a weight never rounds down to 0, a variable keeps a chance however small.*/
+static void initFixedPoint(probsat_t *ps) {
+	int i;
+	double max = 0.0, unit;
+	ps->probsBreakFix = (uint32_t*) malloc(sizeof(uint32_t) * (ps->maxNumOccurences + 1));
+	for (i = 0; i <= ps->maxNumOccurences; i++)
+		if (ps->probsBreak[i] > max)
+			max = ps->probsBreak[i];
+	unit = (double) (UINT32_MAX / (ps->maxClauseSize > 0 ? ps->maxClauseSize : 1));
+	for (i = 0; i <= ps->maxNumOccurences; i++) {
+		ps->probsBreakFix[i] = max > 0.0 ? (uint32_t) (ps->probsBreak[i] / max * unit) : 1;
+		if (ps->probsBreakFix[i] == 0)
+			ps->probsBreakFix[i] = 1;
+	}
+}
+
+/** probsMakeBreakFix from probsMake and probsBreak, scaled the same way as initFixedPoint does.*/
+static void initFixedPointCM(probsat_t *ps) {
+	int m, b, stride = ps->maxNumOccurences + 1;
+	double max = 0.0, unit, w;
+	ps->makeMax = ps->maxNumOccurences;
+	if ((double) stride * stride > CM_TABLE_MAX)
+		ps->makeMax = CM_TABLE_MAX / stride > 1 ? CM_TABLE_MAX / stride - 1 : 0; //a row at least
+	ps->probsMakeBreakFix = (uint32_t*) malloc(sizeof(uint32_t) * (ps->makeMax + 1) * stride);
+	if (ps->probsMakeBreakFix == NULL) { //only --cm on the command line gets here
+		fprintf(stderr, "c Error: Not enough memory for the make and break table\n");
+		exit(-1);
+	}
+	for (m = 0; m <= ps->makeMax; m++)
+		for (b = 0; b < stride; b++)
+			if (ps->probsMake[m] * ps->probsBreak[b] > max)
+				max = ps->probsMake[m] * ps->probsBreak[b];
+	unit = (double) (UINT32_MAX / (ps->maxClauseSize > 0 ? ps->maxClauseSize : 1));
+	for (m = 0; m <= ps->makeMax; m++)
+		for (b = 0; b < stride; b++) {
+			w = ps->probsMake[m] * ps->probsBreak[b];
+			ps->probsMakeBreakFix[m * stride + b] = max > 0.0 ? (uint32_t) (w / max * unit) : 1;
+			if (ps->probsMakeBreakFix[m * stride + b] == 0)
+				ps->probsMakeBreakFix[m * stride + b] = 1;
+		}
+}
+
+void initPoly(probsat_t *ps) {
 	int i;
-	probsBreak = (double*) malloc(sizeof(double) * (maxNumOccurences + 1));
-	for (i = 0; i <= maxNumOccurences; i++) {
-		probsBreak[i] = pow((eps + i), -cb);
+	ps->probsBreak = (double*) malloc(sizeof(double) * (ps->maxNumOccurences + 1));
+	for (i = 0; i <= ps->maxNumOccurences; i++) {
+		ps->probsBreak[i] = pow((ps->eps + i), -ps->cb);
+	}
+	initFixedPoint(ps);
+	if (ps->cm_spec) {
+		ps->probsMake = (double*) malloc(sizeof(double) * (ps->maxNumOccurences + 1));
+		for (i = 0; i <= ps->maxNumOccurences; i++)
+			ps->probsMake[i] = pow((1 + i), ps->cm);
+		initFixedPointCM(ps);
 	}
 }
 
-void initExp() {
+void initExp(probsat_t *ps) {
 	int i;
-	probsBreak = (double*) malloc(sizeof(double) * (maxNumOccurences + 1));
-	for (i = 0; i <= maxNumOccurences; i++) {
-		probsBreak[i] = pow(cb, -i);
+	ps->probsBreak = (double*) malloc(sizeof(double) * (ps->maxNumOccurences + 1));
+	for (i = 0; i <= ps->maxNumOccurences; i++) {
+		ps->probsBreak[i] = pow(ps->cb, -i);
+	}
+	initFixedPoint(ps);
+	if (ps->cm_spec) {
+		ps->probsMake = (double*) malloc(sizeof(double) * (ps->maxNumOccurences + 1));
+		for (i = 0; i <= ps->maxNumOccurences; i++)
+			ps->probsMake[i] = pow(ps->cm, i);
+		initFixedPointCM(ps);
+	}
+}
+
+/** The vector variant the runs use: the one asked for, or the fastest the CPU runs; NULL if none.*/
+static const isaKernel *isaKernelOf(probsat_t *ps) {
+	const isaKernel *x;
+	if (ps->isa > 0)
+		return &isaKernels[ps->isa - 1];
+	for (x = isaKernels; ps->isa < 0 && x->name != NULL; x++)
+		if (x->has())
+			return x;
+	return NULL;
+}
+
+/** Are the occurrences read from occ16: asked for or left to the instance, not with --cm.*/
+static int narrowOf(probsat_t *ps) {
+	return ps->narrow != 0 && ps->occ16 != NULL && !ps->cm_spec;
+}
+
+int probsat_set_kernel(probsat_t *ps, const char *name) {
+	size_t end = name != NULL ? strlen(name) : 0;
+	int narrow = end > 3 && strcmp(name + end - 3, "/16") == 0;
+	const char *isa = name != NULL ? memchr(name, '-', end - 3 * narrow) : NULL;
+	size_t len = isa != NULL ? (size_t) (isa++ - name) : end - 3 * narrow;
+	size_t isaLen = isa != NULL ? (size_t) (name + end - 3 * narrow - isa) : 0;
+	int i, kernel, isaIx = 0;
+	if (name == NULL || strcmp(name, "auto") == 0) {
+		ps->kernel = ps->isa = ps->narrow = -1;
+		return 1;
+	}
+	if ((narrow && ps->occ16 == NULL) || (ps->cm_spec && (narrow || name[0] == 'w'))) //--cm has the general kernel only
+		return 0;
+	if (len == 7 && strncmp(name, "generic", len) == 0 && isa == NULL)
+		kernel = 0;
+	else if (name[0] == 'w' && atoi(name + 1) == ps->width && ps->width < 8 && pickAndFlipNCWidth[ps->width] != NULL
+			&& len == 2) {
+		kernel = ps->width;
+		if (isa != NULL) { //a vector variant, when the CPU runs it
+			for (i = 0; isaKernels[i].name != NULL && (strlen(isaKernels[i].name) != isaLen || strncmp(isaKernels[i].name, isa, isaLen) != 0); i++)
+				;
+			if (isaKernels[i].name == NULL || !isaKernels[i].has())
+				return 0;
+			isaIx = i + 1;
+		}
+	} else
+		return 0;
+	ps->kernel = kernel; //all of the name is valid, the context takes it at once
+	ps->isa = isaIx;
+	ps->narrow = narrow;
+	return 1;
+}
+
+const char *probsat_kernel(probsat_t *ps) {
+	const isaKernel *x;
+	const char *narrow = narrowOf(ps) ? "/16" : "";
+	if (ps->kernel == 0 || ps->cm_spec || ps->width <= 0 || ps->width >= 8 || pickAndFlipNCWidth[ps->width] == NULL) {
+		snprintf(ps->kernelName, sizeof ps->kernelName, "generic%s", narrow);
+		return ps->kernelName;
 	}
+	x = ps->isa != 0 ? isaKernelOf(ps) : NULL;
+	snprintf(ps->kernelName, sizeof ps->kernelName, "w%d%s%s%s", ps->width, x != NULL ? "-" : "", x != NULL ? x->name : "",
+			narrow);
+	return ps->kernelName;
 }
 
-void parseParameters(int argc, char *argv[]) {
+#ifndef PROBSAT_LIB
+/** The context of the command line, for the signal handler.*/
+probsat_t *theSolver;
+/** The RNG options of the command line, as gsat2 has them.*/
+rng_ctrl_t rngCtrl = RNG_CTRL_INIT;
+
+void parseParameters(probsat_t *ps, int argc, char *argv[]) {
 	//define the argument parser
 	static struct option long_options[] =
-			{ { "fct", required_argument, 0, 'f' }, { "caching", required_argument, 0, 'c' }, { "eps", required_argument, 0, 'e' }, { "cb", required_argument, 0, 'b' }, { "runs", required_argument, 0, 't' }, { "maxflips", required_argument, 0, 'm' }, { "printSolution", no_argument, 0, 'a' }, { "help", no_argument, 0, 'h' }, { 0, 0, 0, 0 } };
+			{ { "fct", required_argument, 0, 'f' }, { "caching", required_argument, 0, 'c' }, { "eps", required_argument, 0, 'e' }, { "cb", required_argument, 0, 'b' }, { "cm", required_argument, 0, 'k' }, { "kernel", required_argument, 0, 'K' }, { "runs", required_argument, 0, 't' }, { "maxflips", required_argument, 0, 'm' }, { "printSolution", no_argument, 0, 'a' }, { "help", no_argument, 0, 'h' }, { 0, 0, 0, 0 } };
 
 	while (optind < argc) {
 		int index = -1;
 		struct option * opt = 0;
-		int result = getopt_long(argc, argv, "f:e:c:b:t:m:ah", long_options, &index); //
+		int result = getopt_long(argc, argv, "f:e:c:b:t:m:ah" RNG_OPTS, long_options, &index); //
 		if (result == -1)
 			break; /* end of list */
 		switch (result) {
@@ -590,33 +1125,47 @@ void parseParameters(int argc, char *argv[]) {
 			exit(0);
 			break;
 		case 'c':
-			caching = atoi(optarg);
-			caching_spec = 1;
+			ps->caching = atoi(optarg);
+			ps->caching_spec = 1;
 			break;
 		case 'f':
-			fct = atoi(optarg);
-			fct_spec = 1;
+			ps->fct = atoi(optarg);
+			ps->fct_spec = 1;
 			break;
 		case 'e':
-			eps = atof(optarg);
-			if (eps <= 0) {
+			ps->eps = atof(optarg);
+			if (ps->eps <= 0) {
 				printf("\nERROR: eps should >0!!!\n");
 				exit(0);
 			}
 			break;
 		case 'b':
-			cb = atof(optarg);
-			cb_spec = 1;
+			ps->cb = atof(optarg);
+			ps->cb_spec = 1;
+			break;
+		case 'k': //make is used only when asked for
+			ps->cm = atof(optarg);
+			ps->cm_spec = 1;
+			break;
+		case 'K': //checked once the instance is known
+			kernelArg = optarg;
 			break;
 		case 't': //maximum number of tries to solve the problems within the maxFlips
-			maxTries = atoi(optarg);
+			ps->maxTries = atoi(optarg);
 			break;
 		case 'm': //maximum number of flips to solve the problem
-			maxFlips = atoi(optarg);
+			ps->maxFlips = atoi(optarg);
 			break;
 		case 'a': //print assignment for variables at the end
 			printSol = 1;
 			break;
+		case 'r': //RNG controls
+		case 'R':
+		case 's':
+		case 'S':
+			if (rng_options_r(&rngCtrl, result, optarg, argv[0]) != 0)
+				exit(-1);
+			break;
 		case 0: /* all parameter that do not */
 			/* appear in the optstring */
 			opt = (struct option *) &(long_options[index]);
@@ -639,19 +1188,28 @@ void parseParameters(int argc, char *argv[]) {
 	}
 	fileName = *(argv + optind);
 
-	if (argc > optind + 1) {
-		seed = atoi(*(argv + optind + 1));
-		if (seed == 0)
+	if (rngCtrl.state_given) //the state has priority, as with gsat2
+		ps->seed = 0;
+	else if (rngCtrl.seed_given)
+		ps->seed = rngCtrl.seed;
+	else if (argc > optind + 1) {
+		ps->seed = atoi(*(argv + optind + 1));
+		if (ps->seed == 0)
 			printf("c there might be an error in the command line or is your seed 0?");
 	} else
-		seed = time(0);
+		ps->seed = time(0);
+	if (!rngCtrl.state_given) {
+		rngCtrl.seed = ps->seed;
+		rngCtrl.seed_given = 1;
+	}
 }
 
 void handle_interrupt() {
 	printf("\nc caught signal... exiting\n ");
 	tryTime = elapsed_seconds();
-	printf("\ns UNKNOWN best(%d) (%-15.5fsec)\n", bestNumFalse, tryTime);
-	printEndStatistics();
+	printf("\ns UNKNOWN best(%d) (%-15.5fsec)\n", theSolver->bestNumFalse, tryTime);
+	printEndStatistics(theSolver);
+	rng_end_options_r(&rngCtrl, "probSAT", &theSolver->rng);
 	fflush(NULL);
 	exit(-1);
 }
@@ -663,92 +1221,210 @@ void setupSignalHandler() {
 	signal(SIGABRT, handle_interrupt);
 	signal(SIGKILL, handle_interrupt);
 }
+#endif
 
-void setupParameters() {
-	if (!caching_spec) {
-		if (maxClauseSize <= 3){
-			pickAndFlipVar = pickAndFlipNC; //no caching of the break values in case of 3SAT
-			caching =0;
+void setupParameters(probsat_t *ps) {
+	if (!ps->caching_spec) {
+		if (ps->maxClauseSize <= 3){
+			ps->pickAndFlipVar = pickAndFlipNC; //no caching of the break values in case of 3SAT
+			ps->caching =0;
 		}
 		else{
-			pickAndFlipVar = pickAndFlip; //cache the break values for other k-SAT
-			caching = 1;
+			ps->pickAndFlipVar = pickAndFlip; //cache the break values for other k-SAT
+			ps->caching = 1;
 		}
 	}
 	else{
-		if (caching)
-			pickAndFlipVar = pickAndFlip; //cache the break values for other k-SAT
+		if (ps->caching)
+			ps->pickAndFlipVar = pickAndFlip; //cache the break values for other k-SAT
+		else
+			ps->pickAndFlipVar = pickAndFlipNC; //no caching of the break values in case of 3SAT
+	}
+	ps->initClauses = initClauses;
+	if (ps->width > 0 && ps->width < 8 && pickAndFlipNCWidth[ps->width] != NULL && ps->kernel != 0 && !ps->cm_spec) { //all clauses alike, a kernel for them
+		if (ps->pickAndFlipVar == pickAndFlipNC)
+			ps->pickAndFlipVar = (narrowOf(ps) ? pickAndFlipNCWidthNarrow : pickAndFlipNCWidth)[ps->width];
 		else
-			pickAndFlipVar = pickAndFlipNC; //no caching of the break values in case of 3SAT
-	}
-	if (!cb_spec) {
-		if (maxClauseSize <= 3) {
-			cb = 2.06;
-			eps = 0.9;
-
-		} else if (maxClauseSize <= 4)
-			cb = 2.85;
-		else if (maxClauseSize <= 5)
-			cb = 3.7;
-		else if (maxClauseSize <= 6)
-			cb = 5.1;
+			ps->pickAndFlipVar = (narrowOf(ps) ? pickAndFlipWidthNarrow : pickAndFlipWidth)[ps->width];
+		ps->initClauses = initClausesWidth[ps->width];
+		if (ps->isa != 0 && isaKernelOf(ps) != NULL)
+			ps->initClauses = isaKernelOf(ps)->initClauses;
+	} else if (narrowOf(ps)) //16 bit occurrences
+		ps->pickAndFlipVar = ps->pickAndFlipVar == pickAndFlipNC ? pickAndFlipNCNarrow : pickAndFlipNarrow;
+	if (ps->cm_spec) { //the make values need the break values cached
+		ps->pickAndFlipVar = pickAndFlipCM;
+		ps->caching = 1;
+	}
+	if (!ps->cb_spec) {
+		if (ps->maxClauseSize <= 3) {
+			ps->cb = 2.06;
+			ps->eps = 0.9;
+
+		} else if (ps->maxClauseSize <= 4)
+			ps->cb = 2.85;
+		else if (ps->maxClauseSize <= 5)
+			ps->cb = 3.7;
+		else if (ps->maxClauseSize <= 6)
+			ps->cb = 5.1;
 		else
-			cb = 5.4;
+			ps->cb = 5.4;
 	}
-	if (!fct_spec) {
-		if (maxClauseSize < 4)
-			fct = 0;
+	if (!ps->fct_spec) {
+		if (ps->maxClauseSize < 4)
+			ps->fct = 0;
 		else
-			fct = 1;
+			ps->fct = 1;
 	}
-	if (fct == 0)
-		initLookUpTable = initPoly;
+	if (ps->fct == 0)
+		ps->initLookUpTable = initPoly;
 	else
-		initLookUpTable = initExp;
+		ps->initLookUpTable = initExp;
 }
 
+#ifndef PROBSAT_LIB
 int main(int argc, char *argv[]) {
 	int try = 0;
 	tryTime = 0.;
 	double totalTime = 0.;
-	parseParameters(argc, argv);
-	parseFile();
-	printFormulaProperties();
-	setupParameters(); //call only after parsing file!!!
-	initLookUpTable(); //Initialize the look up table
+	probsat_t *ps = theSolver = newContext();
+	ticks_per_second = sysconf(_SC_CLK_TCK);
+	parseParameters(ps, argc, argv);
+	if (parseFile(ps, fileName))
+		exit(-1);
+	printFormulaProperties(ps);
+	if (!probsat_set_kernel(ps, kernelArg)) {
+		printf("\nERROR: kernel %s unknown, not fitting the instance, not for --cm or not run by this CPU!\n", kernelArg);
+		exit(0);
+	}
+	setupParameters(ps); //call only after parsing file!!!
+	ps->initLookUpTable(ps); //Initialize the look up table
 	setupSignalHandler();
-	printSolverParameters();
-	srand(seed);
-
-	for (try = 0; try < maxTries; try++) {
-		init();
-		bestNumFalse = numClauses;
-		for (flip = 0; flip < maxFlips; flip++) {
-			if (numFalse == 0)
+	if (!rng_apply_options_r(&rngCtrl, argv[0], &ps->rng))
+		exit(-1);
+	printSolverParameters(ps);
+
+	for (try = 0; try < ps->maxTries; try++) {
+		init(ps);
+		ps->bestNumFalse = ps->numClauses;
+		for (ps->flip = 0; ps->flip < ps->maxFlips; ps->flip++) {
+			if (ps->numFalse == 0)
 				break;
-			pickAndFlipVar();
-			printStatsEndFlip(); //update bestNumFalse
+			ps->pickAndFlipVar(ps);
+			printStatsEndFlip(ps); //update bestNumFalse
 		}
 		tryTime = elapsed_seconds();
 		totalTime += tryTime;
-		if (numFalse == 0) {
-			if (!checkAssignment()) {
+		if (ps->numFalse == 0) {
+			if (!checkAssignment(ps)) {
 				fprintf(stderr, "c ERROR the assignment is not valid!");
 				printf("c UNKNOWN");
+				rng_end_options_r(&rngCtrl, argv[0], &ps->rng);
 				return 0;
 			} else {
-				printEndStatistics();
+				printEndStatistics(ps);
 				printf("s SATISFIABLE\n");
 				if (printSol == 1)
-					printSolution();
+					printSolution(ps);
+				rng_end_options_r(&rngCtrl, argv[0], &ps->rng);
 				return 10;
 			}
 		} else
-			printf("c UNKNOWN best(%4d) current(%4d) (%-15.5fsec)\n", bestNumFalse, numFalse, tryTime);
+			printf("c UNKNOWN best(%4d) current(%4d) (%-15.5fsec)\n", ps->bestNumFalse, ps->numFalse, tryTime);
 	}
-	printEndStatistics();
-	if (maxTries > 1)
+	printEndStatistics(ps);
+	if (ps->maxTries > 1)
 		printf("c %-30s: %-8.3fsec\n", "Mean time per try", totalTime / (double) try);
+	rng_end_options_r(&rngCtrl, argv[0], &ps->rng);
 	return 0;
 }
+#else
+/** In-process entry (built with PROBSAT_LIB), see probSAT.h.*/
+probsat_t *probsat_create(const char *file) {
+	probsat_t *ps = newContext();
+	if (ps == NULL)
+		return NULL;
+	if (parseFile(ps, file))
+		return probsat_destroy(ps);
+	return ps;
+}
+
+probsat_t *probsat_destroy(probsat_t *ps) {
+	if (ps != NULL) {
+		freeMemory(ps);
+		free(ps);
+	}
+	return NULL;
+}
+
+/** Seconds on a monotonic clock, for the time bound of the runs.*/
+static double monotonicSeconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+#define CLOCK_MASK 4095 //look at the clock and the stop flag every 4096 flips
+
+void probsat_set_cont(probsat_t *ps, probsat_cont_t *pcont) {
+	ps->pcont = pcont;
+}
+
+void probsat_set_timeout(probsat_t *ps, double seconds) {
+	ps->timeout = seconds > 0 ? seconds : 0;
+}
+
+int probsat_run(probsat_t *ps, double aCb, BIGINT aMaxFlips, BIGINT aMaxTries, BIGINT aSeed, BIGINT *flips, int *satisfied,
+		int *clauses) {
+	int try, solved = 0, ended = 0, leastFalse;
+	double deadline = ps->timeout > 0 ? monotonicSeconds() + ps->timeout : 0;
+	ps->cb = aCb;
+	ps->cb_spec = aCb > 0;
+	ps->eps = 1.0;
+	ps->fct_spec = ps->caching_spec = 0;
+	ps->maxFlips = aMaxFlips;
+	ps->maxTries = aMaxTries;
+	ps->seed = aSeed;
+	setupParameters(ps);
+	free(ps->probsBreak); //of the previous run
+	free(ps->probsBreakFix);
+	ps->initLookUpTable(ps);
+	rng_set_seed_r(&ps->rng, ps->seed);
+
+	*flips = 0;
+	leastFalse = ps->numClauses;
+	for (try = 0; try < ps->maxTries && !solved && !ended; try++) {
+		init(ps);
+		ps->bestNumFalse = ps->numClauses;
+		for (ps->flip = 0; ps->flip < ps->maxFlips; ps->flip++) {
+			if (ps->numFalse == 0)
+				break;
+			if ((ps->flip & CLOCK_MASK) == 0 && ((ps->pcont != NULL && !atomic_load_explicit(ps->pcont, memory_order_relaxed))
+					|| (deadline > 0 && monotonicSeconds() >= deadline))) { //stopped or out of time
+				ended = 1;
+				break;
+			}
+			ps->pickAndFlipVar(ps);
+			printStatsEndFlip(ps); //update bestNumFalse
+		}
+		*flips += ps->flip;
+		if (ps->bestNumFalse > ps->numFalse) //no flip made, the initial assignment counts
+			ps->bestNumFalse = ps->numFalse;
+		if (ps->bestNumFalse < leastFalse)
+			leastFalse = ps->bestNumFalse;
+		solved = ps->numFalse == 0 && checkAssignment(ps);
+	}
+	*satisfied = ps->numClauses - leastFalse;
+	*clauses = ps->numClauses;
+	return solved;
+}
 
+int probsat_solve(const char *file, double aCb, BIGINT aMaxFlips, BIGINT aMaxTries, BIGINT aSeed, BIGINT *flips, int *satisfied,
+		int *clauses) {
+	int solved;
+	probsat_t *ps = probsat_create(file);
+	if (ps == NULL)
+		return -1;
+	solved = probsat_run(ps, aCb, aMaxFlips, aMaxTries, aSeed, flips, satisfied, clauses);
+	probsat_destroy(ps);
+	return solved;
+}
+#endif
@@ -0,0 +1,46 @@
+#ifndef PROBSAT_H
+#define PROBSAT_H
+
+#include <stdatomic.h>
+
+/** probSAT inside the calling process (built with PROBSAT_LIB), as pygsat, gsatd and gsatbench
+ * use it, no probSAT process started: a context holds an instance and everything a run changes,
+ * its random numbers too; contexts share nothing, so several may run in threads of their own.*/
+typedef struct probsat probsat_t;
+
+/** A context for the instance in file (DIMACS or binary, see cnf2bin), NULL when it cannot be read.*/
+probsat_t *probsat_create(const char *file);
+/** Releases the context and all it holds; returns NULL.*/
+probsat_t *probsat_destroy(probsat_t *ps);
+
+/** Solves the instance quietly as probSAT would with --cb cb (0: instance dependent), -m maxFlips,
+ * --runs maxTries and the seed given (probSAT <instance> <seed>); it may be solved again,
+ * with other parameters.
+ * Reports the flips of all tries and the most clauses satisfied at once in a try.
+ * Returns 1 when satisfied, 0 when not.*/
+int probsat_run(probsat_t *ps, double cb, long long maxFlips, long long maxTries, long long seed,
+		long long *flips, int *satisfied, int *clauses);
+
+/** A run goes on while *pcont is not 0, e.g. until another thread clears it; NULL (the default)
+ * none to look at. It is read every 4096 flips and never set again by the runs.*/
+typedef _Atomic int probsat_cont_t;
+void probsat_set_cont(probsat_t *ps, probsat_cont_t *pcont);
+
+/** The runs end after seconds of time, each, when not solved before; 0 (the default) no limit.*/
+void probsat_set_timeout(probsat_t *ps, double seconds);
+
+/** The kernel of the runs: "generic" for any instance, "w3", "w4", "w5", "w7" for all clauses
+ * of that width, these with "-avx2" or "-avx512" for the pass over all clauses at every try
+ * done in vectors; any with "/16" for 16 bit clause indices, for at most 65536 clauses.
+ * NULL or "auto" the fitting one the CPU runs (the default), narrow when the instance allows.
+ * Returns 0 when unknown, not fitting or not run by the CPU, 1 otherwise.*/
+int probsat_set_kernel(probsat_t *ps, const char *name);
+/** The kernel the runs use.*/
+const char *probsat_kernel(probsat_t *ps);
+
+/** probsat_create, probsat_run and probsat_destroy in one.
+ * Returns 1 when satisfied, 0 when not, -1 when the file cannot be read.*/
+int probsat_solve(const char *file, double cb, long long maxFlips, long long maxTries, long long seed,
+		long long *flips, int *satisfied, int *clauses);
+
+#endif
@@ -0,0 +1,235 @@
+/*-----------------------------------------------------------------------------*/
+/*   pygsat: gsat2 and probSAT runs inside Python                              */
+/*   run_batch makes a run per (path, seed) pair with the GIL released, so     */
+/*   several Python threads run side by side; results come back as arrays     */
+/*   of signed 64-bit integers (array.array 'q', numpy.frombuffer takes them)  */
+/*-----------------------------------------------------------------------------*/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include "../gsat2-distr/gsat_solver.h"
+#include "../probSAT-master/probSAT.h"
+
+enum { PG_GSAT, PG_PROBSAT };
+
+typedef struct {                /* a batch as C sees it */
+    int         solver;
+    Py_ssize_t  runs;
+    char**      path;
+    uint64_t*   seed;
+    int         max_flips;      /* per try, 0: no limit */
+    int         max_tries;      /* 0: no limit */
+    double      p;              /* gsat: probability of a random step */
+    double      cb;             /* probSAT: break constant, 0: instance dependent */
+    double      seconds;        /* per run, 0: no limit */
+    long long*  flips;          /* results */
+    long long*  satisfied;
+    long long*  clauses;
+    Py_ssize_t  failed;         /* the run that failed, or -1 */
+    int         err;            /* errno or inst_read error of it */
+} pg_batch_t;
+
+/*-----------------------------------------------------------------------------*/
+/*      seconds on a monotonic clock                                           */
+/*-----------------------------------------------------------------------------*/
+static double pg_now (void) {
+#ifdef _MSC_VER
+    return (double)clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+#endif
+}
+/*-----------------------------------------------------------------------------*/
+/*      a run not solved within its seconds reports -1 flips                   */
+/*-----------------------------------------------------------------------------*/
+static int pg_late (pg_batch_t* b, int solved, double start) {
+    return !solved && b->seconds > 0 && pg_now () - start >= b->seconds;
+}
+/*-----------------------------------------------------------------------------*/
+/*      gsat: the handle is kept while the path stays the same                 */
+/*-----------------------------------------------------------------------------*/
+static void pg_gsat (pg_batch_t* b) {
+    gsat_solver_t* s = NULL;
+    const char* last = NULL;
+    inst_t inst;
+    FILE* in;
+    double start;
+    int solved;
+    Py_ssize_t i;
+
+    for (i=0; i<b->runs; i++) {
+        if (!s || strcmp (last, b->path[i]) != 0) {
+            s = gsat_destroy (s);
+            if (!(in = fopen (b->path[i], "rb"))) { b->err = errno; break; }
+            b->err = inst_read (&inst, in, 0);
+            fclose (in);
+            if (b->err) break;
+            if (!(s = gsat_create (&inst))) { inst_forget (&inst); b->err = ERR_ALLOC; break; }
+            gsat_set_itrmax (s, b->max_flips);
+            gsat_set_triesmax (s, b->max_tries);
+            gsat_set_p (s, b->p);
+            last = b->path[i];
+        }
+        gsat_set_seed (s, b->seed[i]);                  /* as gsat2 -r */
+        start = pg_now ();
+        if ((solved = gsat_run (s, 0, b->seconds)) < 0) { b->err = ERR_ALLOC; break; }
+        b->flips[i] = pg_late (b, solved, start) ? -1 : gsat_flips (s);
+        b->satisfied[i] = gsat_satisfied (s);
+        b->clauses[i] = gsat_inst (s)->length;
+    }
+    if (i < b->runs) b->failed = i;
+    gsat_destroy (s);
+}
+/*-----------------------------------------------------------------------------*/
+/*      probSAT: the context is kept while the path stays the same            */
+/*-----------------------------------------------------------------------------*/
+static void pg_probsat (pg_batch_t* b) {
+    long long tries = b->max_tries ? b->max_tries : LLONG_MAX;
+    long long flipmax = b->max_flips ? b->max_flips : LLONG_MAX;
+    probsat_t* ps = NULL;
+    const char* last = NULL;
+    int satisfied, clauses, solved;
+    double start;
+    Py_ssize_t i;
+
+    for (i=0; i<b->runs; i++) {
+        if (!ps || strcmp (last, b->path[i]) != 0) {
+            ps = probsat_destroy (ps);
+            if (!(ps = probsat_create (b->path[i]))) { b->failed = i; b->err = ERR_FORMAT; return; }
+            probsat_set_timeout (ps, b->seconds);
+            last = b->path[i];
+        }
+        start = pg_now ();
+        solved = probsat_run (ps, b->cb, flipmax, tries, (long long)b->seed[i], &b->flips[i], &satisfied, &clauses);
+        if (pg_late (b, solved, start)) b->flips[i] = -1;
+        b->satisfied[i] = satisfied;
+        b->clauses[i] = clauses;
+    }
+    probsat_destroy (ps);
+}
+/*-----------------------------------------------------------------------------*/
+/*      array.array('q') holding n items of v                                  */
+/*-----------------------------------------------------------------------------*/
+static PyObject* pg_array (long long* v, Py_ssize_t n) {
+    PyObject *mod, *arr, *bytes, *rtn;
+    if (!(mod = PyImport_ImportModule ("array"))) return NULL;
+    arr = PyObject_CallMethod (mod, "array", "s", "q");
+    Py_DECREF (mod);
+    if (!arr) return NULL;
+    if (!(bytes = PyBytes_FromStringAndSize ((char*)v, n*sizeof(long long)))) { Py_DECREF (arr); return NULL; }
+    rtn = PyObject_CallMethod (arr, "frombytes", "O", bytes);
+    Py_DECREF (bytes);
+    if (!rtn) { Py_DECREF (arr); return NULL; }
+    Py_DECREF (rtn);
+    return arr;
+}
+/*-----------------------------------------------------------------------------*/
+static void pg_batch_free (pg_batch_t* b) {
+    Py_ssize_t i;
+    if (b->path) for (i=0; i<b->runs; i++) free (b->path[i]);
+    free (b->path);
+    free (b->seed);
+    free (b->flips);
+    free (b->satisfied);
+    free (b->clauses);
+}
+/*-----------------------------------------------------------------------------*/
+/*      run_batch (solver, paths, seeds, max_flips, max_tries, p=0.4, cb=0.0,  */
+/*                 seconds=0.0)                                                */
+/*-----------------------------------------------------------------------------*/
+static PyObject* pg_run_batch (PyObject* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = {"solver", "paths", "seeds", "max_flips", "max_tries", "p", "cb", "seconds", NULL};
+    const char* solver;
+    PyObject *paths, *seeds, *pseq=NULL, *sseq=NULL, *item, *enc, *rtn=NULL;
+    PyObject *flips=NULL, *satisfied=NULL, *clauses=NULL;
+    pg_batch_t b;
+    Py_ssize_t i;
+
+    memset (&b, 0, sizeof b);
+    b.p = 0.4;
+    b.failed = -1;
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "sOOii|ddd", kwlist, &solver, &paths, &seeds,
+                                      &b.max_flips, &b.max_tries, &b.p, &b.cb, &b.seconds)) return NULL;
+    if (strcmp (solver, "gsat") == 0) b.solver = PG_GSAT;
+    else if (strcmp (solver, "probsat") == 0) b.solver = PG_PROBSAT;
+    else { PyErr_Format (PyExc_ValueError, "unknown solver '%s', 'gsat' or 'probsat' expected", solver); return NULL; }
+    if (b.max_flips < 0 || b.max_tries < 0 || b.p < 0.0 || b.p > 1.0 || b.cb < 0.0 || b.seconds < 0.0) {
+        PyErr_SetString (PyExc_ValueError, "max_flips, max_tries, cb and seconds must not be negative, p must lie in 0..1");
+        return NULL;
+    }
+    /* ----------------------- arguments to C ----------------- */
+    if (!(pseq = PySequence_Fast (paths, "paths must be a sequence"))) goto done;
+    if (!(sseq = PySequence_Fast (seeds, "seeds must be a sequence"))) goto done;
+    b.runs = PySequence_Fast_GET_SIZE (pseq);
+    if (PySequence_Fast_GET_SIZE (sseq) != b.runs) {
+        PyErr_SetString (PyExc_ValueError, "paths and seeds differ in length"); goto done;
+    }
+    b.path = calloc (b.runs+1, sizeof(char*));
+    b.seed = calloc (b.runs+1, sizeof(uint64_t));
+    b.flips = calloc (b.runs+1, sizeof(long long));
+    b.satisfied = calloc (b.runs+1, sizeof(long long));
+    b.clauses = calloc (b.runs+1, sizeof(long long));
+    if (!b.path || !b.seed || !b.flips || !b.satisfied || !b.clauses) { PyErr_NoMemory (); goto done; }
+    for (i=0; i<b.runs; i++) {
+        if (!PyUnicode_FSConverter (PySequence_Fast_GET_ITEM (pseq, i), &enc)) goto done;
+        b.path[i] = strdup (PyBytes_AS_STRING (enc));
+        Py_DECREF (enc);
+        if (!b.path[i]) { PyErr_NoMemory (); goto done; }
+        item = PySequence_Fast_GET_ITEM (sseq, i);
+        b.seed[i] = PyLong_AsUnsignedLongLongMask (item);
+        if (PyErr_Occurred ()) goto done;
+    }
+    /* ----------------------- the runs ----------------------- */
+    Py_BEGIN_ALLOW_THREADS
+    if (b.solver == PG_GSAT) pg_gsat (&b); else pg_probsat (&b);
+    Py_END_ALLOW_THREADS
+    if (b.failed >= 0) {
+        if (b.err > 0) PyErr_SetFromErrnoWithFilename (PyExc_OSError, b.path[b.failed]);
+        else if (b.err == ERR_ALLOC) PyErr_NoMemory ();
+        else PyErr_Format (PyExc_ValueError, "%s: not a readable CNF instance (%d)", b.path[b.failed], b.err);
+        goto done;
+    }
+    /* ----------------------- results ------------------------ */
+    if ((flips = pg_array (b.flips, b.runs)) && (satisfied = pg_array (b.satisfied, b.runs))
+        && (clauses = pg_array (b.clauses, b.runs))) {
+        rtn = PyTuple_Pack (3, flips, satisfied, clauses);
+    }
+done:
+    Py_XDECREF (flips);
+    Py_XDECREF (satisfied);
+    Py_XDECREF (clauses);
+    Py_XDECREF (pseq);
+    Py_XDECREF (sseq);
+    pg_batch_free (&b);
+    return rtn;
+}
+
+static PyMethodDef pg_methods[] = {
+    {"run_batch", (PyCFunction)(void(*)(void))pg_run_batch, METH_VARARGS | METH_KEYWORDS,
+     "run_batch(solver, paths, seeds, max_flips, max_tries, p=0.4, cb=0.0, seconds=0.0)\n"
+     "--\n\n"
+     "Run solver ('gsat' or 'probsat') once for every paths[i], seeds[i] pair,\n"
+     "max_flips per try, max_tries tries (0: no limit). p is the gsat random step\n"
+     "probability, cb the probSAT break constant (0: instance dependent),\n"
+     "seconds the time each run may take (0: no limit).\n"
+     "A gsat seed is the number gsat2 -r takes, a probSAT seed the one probSAT does.\n"
+     "Returns (flips, satisfied, clauses), arrays of signed 64-bit integers:\n"
+     "the flips of all tries (-1 when out of time), the clauses satisfied as\n"
+     "the command line tool reports them, and the clauses of the instance.\n"
+     "The GIL is released while solving."},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef pg_module = {
+    PyModuleDef_HEAD_INIT, "pygsat", "gsat2 and probSAT runs in-process.", -1, pg_methods
+};
+
+PyMODINIT_FUNC PyInit_pygsat (void) {
+    return PyModule_Create (&pg_module);
+}
@@ -0,0 +1,35 @@
+"""Builds the pygsat extension from the solver sources in place:
+
+    cd lib/pygsat && python3 setup.py build_ext --inplace
+
+script.py then finds it next to this file.
+"""
+import os
+from setuptools import setup, Extension
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+GSAT = os.path.join("..", "gsat2-distr")
+PROBSAT = os.path.join("..", "probSAT-master")
+
+os.chdir(HERE)
+setup(
+    name="pygsat",
+    version="1.0",
+    description="gsat2 and probSAT runs in-process",
+    ext_modules=[
+        Extension(
+            "pygsat",
+            sources=[
+                "pygsat.c",
+                os.path.join(GSAT, "gsat_solver.c"),
+                os.path.join(GSAT, "sat_inst.c"),
+                os.path.join(GSAT, "sat_sol.c"),
+                os.path.join(GSAT, "xoshiro256plus.c"),
+                os.path.join(PROBSAT, "probSAT.c"),
+            ],
+            define_macros=[("PROBSAT_LIB", None)],
+            extra_compile_args=["-O3"],
+            libraries=["m", "pthread"],
+        )
+    ],
+)
@@ -12,6 +12,7 @@ import datetime
 import os
 import random
 import subprocess
+import sys
 import time
 from dataclasses import dataclass
 import pandas as pd
@@ -23,6 +24,13 @@ GSAT_PROB = 0.4
 
 GSAT_EXE_FILEPATH = "bin/gsat2"
 
+# the in-process solvers, when built (cd lib/pygsat && python3 setup.py build_ext --inplace)
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "lib", "pygsat"))
+try:
+    import pygsat
+except ImportError:
+    pygsat = None
+
 # define output data structure with data class
 @dataclass
 class AlgorithmOutput:
@@ -33,6 +41,15 @@ class AlgorithmOutput:
 def run_gsat(cnf_filepath, seed, max_flips, max_tries,timeout_seconds=None, prob=GSAT_PROB):
     """ Run executable linux from bin/gsat2 with given CNF formula."""
 
+    if pygsat is not None:
+        # gsat2 -r reads the seed as a hex number, the module takes it as is
+        flips, satisfied, total = pygsat.run_batch("gsat", [cnf_filepath], [int(str(seed), 16)], max_flips, max_tries, p=prob,
+                                                   seconds=timeout_seconds or 0)
+        if flips[0] < 0:
+            print(f"GSAT timed out after {timeout_seconds} seconds.")
+            return None
+        return AlgorithmOutput(iteration_count=flips[0], clause_satisfied=satisfied[0], clause_total=total[0])
+
     start = time.monotonic()
     try:
 
@@ -75,12 +92,21 @@ def run_gsat(cnf_filepath, seed, max_flips, max_tries,timeout_seconds=None, prob
 
 PROBSAT_EXE_FILEPATH = "bin/probSAT"
 
-PROBSAT_CM = 0 # set defualt in ./bin/probSAT
+PROBSAT_CM = None # None = only break; a number turns on make+break (--cm), CLI only
 PROBSAT_CB = 2.3
 #  cmd = ["./probSAT", filename, "cb=2.3", "cm=0", f"cutoff={max_flips}"]
 
-def run_probsat(cnf_filepath, seed, max_flips, max_tries, timeout_seconds=None, cb=PROBSAT_CB):
+def run_probsat(cnf_filepath, seed, max_flips, max_tries, timeout_seconds=None, cb=PROBSAT_CB, cm=PROBSAT_CM):
     """ Run executable linux from bin/probSAT with given CNF formula."""
+    if pygsat is not None and cm is None:
+        # max_tries 0 is no limit, as probSAT without --runs
+        flips, satisfied, total = pygsat.run_batch("probsat", [cnf_filepath], [int(seed)], max_flips, max_tries or 0, cb=cb,
+                                                   seconds=timeout_seconds or 0)
+        if flips[0] < 0:
+            print(f"probSAT timed out after {timeout_seconds} seconds.")
+            return None
+        return AlgorithmOutput(iteration_count=flips[0], clause_satisfied=satisfied[0], clause_total=total[0])
+
     time_start = time.monotonic()
     try:
 
@@ -100,6 +126,9 @@ def run_probsat(cnf_filepath, seed, max_flips, max_tries, timeout_seconds=None,
                    seed.__str__()
                    ]
 
+        if cm is not None:
+            cmd[1:1] = ["--cm", cm.__str__()]
+
         #print(f"Running probSAT command: {' '.join(cmd)}")
         result = subprocess.run(cmd, capture_output=True, text=True, timeout=timeout_seconds)
 